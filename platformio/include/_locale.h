@@ -69,6 +69,11 @@ extern const char *TXT_WIFI_FAIR;
 extern const char *TXT_WIFI_WEAK;
 extern const char *TXT_WIFI_NO_CONNECTION;
 
+// REFRESH MODES
+extern const char *TXT_REFRESH_FULL;
+extern const char *TXT_REFRESH_FAST;
+extern const char *TXT_REFRESH_PARTIAL;
+
 // UNIT SYMBOLS - TEMPERATURE
 extern const char *TXT_UNITS_TEMP_KELVIN;
 extern const char *TXT_UNITS_TEMP_CELSIUS;
@@ -0,0 +1,133 @@
+/* Chart engine for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __CHART_H__
+#define __CHART_H__
+
+#include <cstdint>
+#include "display_list.h"
+
+// most points plotted per series, longer series are decimated to as many, and
+// most series per chart
+#define CHART_POINTS 48
+#define CHART_SERIES 5
+
+/* A value axis with evenly spaced grid lines, from min at the bottom of the
+ * chart to max at the top, see niceAxis().
+ */
+typedef struct chart_axis {
+  float min;
+  float max;
+  float step;       // between grid lines
+  uint8_t decimals; // needed to print the values at the grid lines
+} chart_axis_t;
+
+/* How a series with more samples than CHART_POINTS is decimated.
+ */
+typedef enum chart_decimation : uint8_t
+{
+  CHART_LTTB, // Largest-Triangle-Three-Buckets, keeps the shape of lines
+  CHART_MAX   // largest sample in each bucket, keeps the peaks of bars
+} chart_decimation_t;
+
+/* A mark, e.g. an icon, to be placed next to a line series at the tick mark
+ * of a sample, see Chart::placeMarks().
+ */
+typedef struct chart_mark {
+  uint16_t sample;
+  int16_t x; // left column
+  int16_t y; // top row, or INT16_MAX if there is no room for the mark
+} chart_mark_t;
+
+class Chart;
+typedef struct chart_series chart_series_t;
+
+/* Draws a series, from the pixel coordinates Chart::layout() computed.
+ */
+typedef void (*chart_renderer_t)(DisplayList &gfx, const Chart &chart,
+                                 const chart_series_t &series);
+
+struct chart_series {
+  float value[CHART_POINTS];
+  uint16_t sample[CHART_POINTS]; // each point is, or starts the bucket of
+  int16_t y[CHART_POINTS];       // of each value on axis, see Chart::layout()
+  uint8_t points;
+  float lo; // of all samples, not just the points
+  float hi;
+  chart_axis_t axis;
+  chart_renderer_t render;
+  uint16_t color;
+  uint8_t width; // of lines
+};
+
+chart_axis_t niceAxis(float lo, float hi, uint8_t ticks, float minStep);
+
+void chartLine(DisplayList &gfx, const Chart &chart,
+               const chart_series_t &series);
+void chartBars(DisplayList &gfx, const Chart &chart,
+               const chart_series_t &series);
+void chartHatched(DisplayList &gfx, const Chart &chart,
+                  const chart_series_t &series);
+
+/* Any number of series over the same samples in time, drawn over a grid of
+ * dotted lines, one for each tick of the axes.
+ *
+ * Series are added and their values and axes filled in, then layout()
+ * computes every pixel coordinate in one pass, and draw() draws the grid and
+ * the series in the order they were added. However many samples there are,
+ * at most CHART_POINTS of each series are laid out and drawn.
+ */
+class Chart {
+public:
+  Chart(int16_t left, int16_t top, int16_t right, int16_t bottom,
+        uint16_t samples, uint8_t ticks);
+
+  chart_series_t *addSeries(chart_renderer_t render, uint16_t color,
+                            uint8_t width = 1);
+  void setValues(chart_series_t &series, const float *values,
+                 chart_decimation_t decimation) const;
+  void layout();
+  void draw(DisplayList &gfx) const;
+
+  int16_t left() const { return _left; }
+  int16_t top() const { return _top; }
+  int16_t right() const { return _right; }
+  int16_t bottom() const { return _bottom; }
+  uint16_t samples() const { return _samples; }
+  uint8_t ticks() const { return _ticks; }
+  int16_t sampleX(uint16_t i) const;
+  int16_t slotLeft(uint16_t i) const;
+  int16_t tickX(uint16_t i) const;
+  int16_t gridY(uint8_t tick) const;
+  void placeMarks(const chart_series_t &line, chart_mark_t *marks, uint8_t n,
+                  int16_t w, int16_t h, int16_t minY) const;
+  size_t size() const { return _size; }
+  const chart_series_t &series(size_t i) const { return _series[i]; }
+
+private:
+  int16_t _left;
+  int16_t _top;
+  int16_t _right;
+  int16_t _bottom;
+  uint16_t _samples;
+  uint8_t _ticks;
+  float _interval;
+  size_t _size;
+  chart_series_t _series[CHART_SERIES];
+};
+
+#endif
@@ -72,7 +72,11 @@
 //   Italiano (Italia)               it_IT
 //   Dutch (Belgium)                 nl_BE
 //   Portuguese (Brazil)             pt_BR
-#define LOCALE de_DE
+// LOCALE and FONT_HEADER may also be set with build flags, which take
+// precedence (see tools/render_check.sh).
+#ifndef LOCALE
+  #define LOCALE de_DE
+#endif
 
 // UNITS
 // Define exactly one macro for each measurement type below.
@@ -222,7 +226,9 @@
 //   FreeSans font, but this project supports the ability to modularly swap
 //   fonts. Using a font other than FreeSans may result in undesired spacing or
 //   other artifacts.
-#define FONT_HEADER "fonts/FreeSans.h"
+#ifndef FONT_HEADER
+  #define FONT_HEADER "fonts/FreeSans.h"
+#endif
 
 // DAILY PRECIPITATION
 // Daily precipitation indicated under Hi|Lo can optionally be configured using
@@ -239,12 +245,47 @@
 //   1 : Enable
 #define DISPLAY_HOURLY_ICONS 1
 
+// HOURLY OUTLOOK GRAPH SERIES
+// Additional hourly forecasts to be drawn on the temperature and
+// precipitation chart. Each is drawn as a thin line, scaled to fit the chart,
+// without axis labels.
+//   0 : Disable
+//   1 : Enable
+#define DISPLAY_HOURLY_PRESSURE 0
+#define DISPLAY_HOURLY_HUMIDITY 0
+#define DISPLAY_HOURLY_WIND     0
+
 
 // STATUS BAR EXTRAS
 //   Extra information that can be displayed on the status bar. Set to 1 to
 //   enable.
 #define STATUS_BAR_EXTRAS_BAT_VOLTAGE 0
 #define STATUS_BAR_EXTRAS_WIFI_RSSI   0
+#define STATUS_BAR_EXTRAS_REFRESH     0
+
+// SKIP UNCHANGED FRAMES
+//   The display is not refreshed, or even powered on, when the new frame looks
+//   exactly like the one already on the display. Status bar items enabled
+//   below are ignored in this comparison, as they change on most wakes. The
+//   status bar then keeps showing them as they were at the last refresh. Set
+//   to 1 to enable.
+#define SKIP_UNCHANGED_IGNORE_REFRESH_TIME 1
+#define SKIP_UNCHANGED_IGNORE_WIFI_SIGNAL  0
+
+// WIDGET CACHE
+//   The forecast of each day, the indoor temperature and humidity and the
+//   location and date are copied from the frame on the display, instead of
+//   being drawn again, while what they show stays the same. How often each was
+//   copied is printed over the serial port. Black and white panels only. Set to
+//   1 to enable.
+#define WIDGET_CACHE 1
+
+// CLOCK
+//   Shows the time left of the location and date. Between weather updates the
+//   ESP32 wakes every minute to update just the clock with a partial refresh,
+//   without WiFi. The clock stops between BED_TIME and WAKE_TIME, along with
+//   the weather updates. Black and white panels only. Set to 1 to enable.
+#define DISPLAY_CLOCK 0
 
 // BATTERY MONITORING
 //   You may choose to power your weather display with or without a battery.
@@ -298,6 +339,15 @@ extern const int SLEEP_DURATION;
 extern const int BED_TIME;
 extern const int WAKE_TIME;
 extern const int HOURLY_GRAPH_MAX;
+extern const uint32_t CPU_FREQ_HIGH;
+extern const uint32_t CPU_FREQ_LOW;
+extern const uint32_t WAKE_TIME_BUDGET;
+extern const uint32_t WAKE_CHARGE_BUDGET;
+extern const uint32_t FULL_REFRESH_INTERVAL;
+extern const uint32_t FULL_REFRESH_AREA;
+extern const uint32_t CLEAN_REFRESH_INTERVAL;
+extern const uint32_t CLEAN_REFRESH_AREA;
+extern const float FAST_REFRESH_MIN_TEMP;
 extern const uint32_t WARN_BATTERY_VOLTAGE;
 extern const uint32_t LOW_BATTERY_VOLTAGE;
 extern const uint32_t VERY_LOW_BATTERY_VOLTAGE;
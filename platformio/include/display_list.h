@@ -0,0 +1,160 @@
+/* Display list declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __DISPLAY_LIST_H__
+#define __DISPLAY_LIST_H__
+
+#include <cstdint>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "glyph_cache.h"
+#include "text_metrics.h"
+
+typedef enum dl_op_type : uint8_t
+{
+  DL_GLYPH,
+  DL_LINE,
+  DL_FILL_RECT,
+  DL_PIXELS,
+  DL_INVERTED_BITMAP,
+  DL_PATTERN
+} dl_op_type_t;
+
+/* One recorded draw call. top and bottom are the first and last row it
+ * touches, so that it can be skipped when replaying a page band it is not in.
+ */
+typedef struct dl_op {
+  const void *data; // GFXfont for glyphs, bitmap for bitmaps, pattern
+  int16_t top;
+  int16_t bottom;
+  int16_t x0;
+  int16_t y0;       // pattern origin x for patterns
+  int16_t x1;       // line end, rect size, pixel count and stride, glyph
+  int16_t y1;       // size and character, pattern origin y
+  uint16_t color;
+  dl_op_type_t type;
+} dl_op_t;
+
+/* How the segments of a thick polyline are joined. Miter joins leave the ends
+ * of the line square, round joins round them too.
+ */
+typedef enum dl_join : uint8_t
+{
+  DL_JOIN_MITER,
+  DL_JOIN_ROUND
+} dl_join_t;
+
+/* A band of rows of a 1 bit per pixel frame in the GxEPD2 layout (1 = white),
+ * (width + 7) / 8 bytes per row, that bitmaps can be blitted into a byte at a
+ * time instead of pixel by pixel.
+ */
+typedef struct dl_raster {
+  uint8_t *buffer;
+  int16_t width;
+  int16_t top;
+  int16_t rows;
+} dl_raster_t;
+
+/* A fill pattern, repeating every period pixels (1 to 32) along a row and
+ * every rows rows (1 to 8) down. The top period bits of bits[r] are row r,
+ * the most significant bit being its first pixel, and set bits are drawn.
+ */
+typedef struct dl_pattern {
+  uint32_t bits[8];
+  uint8_t period;
+  uint8_t rows;
+} dl_pattern_t;
+
+extern const dl_pattern_t DL_PATTERN_CHECKER;  // every other pixel, staggered
+extern const dl_pattern_t DL_PATTERN_HATCH;    // diagonal lines, 4 pixels apart
+extern const dl_pattern_t DL_PATTERN_DOTS;     // every other pixel and row
+extern const dl_pattern_t DL_PATTERN_DOTTED_H; // every third pixel along a row
+extern const dl_pattern_t DL_PATTERN_DOTTED_V; // every third row
+
+typedef struct dl_rect {
+  int16_t x;
+  int16_t y;
+  int16_t w;
+  int16_t h;
+} dl_rect_t;
+
+/* Drawing surface that records draw calls instead of rasterizing them.
+ *
+ * Layout (text measurement, font metrics, graph math) runs once while the
+ * frame is recorded. The recorded frame is then replayed into a paged frame
+ * buffer one page band at a time, and only the draw calls that touch a band
+ * are rasterized into it. Runs of pixels along a row are recorded as one call.
+ */
+class DisplayList : public Adafruit_GFX {
+public:
+  DisplayList(int16_t w, int16_t h, size_t capacity = 0);
+
+  void clear();
+  size_t size() const { return _ops.size(); }
+  const dl_op_t &op(size_t i) const { return _ops[i]; }
+  void append(const dl_op_t &op) { _ops.push_back(op); }
+  size_t bytes() const { return _ops.capacity() * sizeof(dl_op_t); }
+  void replay(Adafruit_GFX &target, int16_t top, int16_t bottom,
+              const dl_raster_t *raster = nullptr) const;
+  void markVolatile(int16_t x, int16_t y, int16_t w, int16_t h);
+  const std::vector<dl_rect_t> &volatileRects() const { return _volatile; }
+  const GFXfont *font() const { return gfxFont; }
+  dl_rect_t inkBounds(size_t first, size_t last, const dl_rect_t &clip) const;
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                uint16_t color) override;
+  void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                uint16_t color) override;
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color,
+                          bool pgm = true);
+  void drawPolyline(const int16_t *x, const int16_t *y, size_t n,
+                    uint8_t width, dl_join_t join, uint16_t color);
+  void fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                   const dl_pattern_t &pattern, uint16_t color,
+                   int16_t originX = 0, int16_t originY = 0);
+  void drawPatternHLine(int16_t x, int16_t y, int16_t w,
+                        const dl_pattern_t &pattern, uint16_t color,
+                        int16_t originX = 0, int16_t originY = 0) {
+    fillPattern(x, y, w, 1, pattern, color, originX, originY);
+  }
+  void drawPatternVLine(int16_t x, int16_t y, int16_t h,
+                        const dl_pattern_t &pattern, uint16_t color,
+                        int16_t originX = 0, int16_t originY = 0) {
+    fillPattern(x, y, 1, h, pattern, color, originX, originY);
+  }
+  using Adafruit_GFX::write;
+  size_t write(uint8_t c) override;
+  void getTextBounds(const char *str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h);
+  void getTextBounds(const String &str, int16_t x, int16_t y, int16_t *x1,
+                     int16_t *y1, uint16_t *w, uint16_t *h);
+
+private:
+  void addGlyph(unsigned char c);
+  bool blitGlyph(const dl_raster_t &raster, const dl_op_t &op, int16_t top,
+                 int16_t bottom) const;
+  TextCache _textCache;
+  mutable GlyphCache _glyphs; // filled while replaying
+  std::vector<dl_op_t> _ops;
+  std::vector<dl_rect_t> _volatile;
+};
+
+#endif
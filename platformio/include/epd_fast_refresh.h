@@ -0,0 +1,44 @@
+/* Fast refresh e-paper driver declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __EPD_FAST_REFRESH_H__
+#define __EPD_FAST_REFRESH_H__
+
+#include <GxEPD2_BW.h>
+
+/* GxEPD2_750_T7 with an optional fast full refresh.
+ *
+ * The UC8179 controller picks the full refresh waveform from its OTP by the
+ * panel temperature it measures. Forcing a high temperature instead selects
+ * the high temperature waveform, which is less than half as long and flashes
+ * less. It leaves more ghosting behind, and gives poor contrast on a cold
+ * panel.
+ */
+class GxEPD2_750_T7_Fast : public GxEPD2_750_T7 {
+public:
+  GxEPD2_750_T7_Fast(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+      : GxEPD2_750_T7(cs, dc, rst, busy), _fast(false) {}
+
+  void setFastFullRefresh(bool fast) { _fast = fast; }
+  using GxEPD2_750_T7::refresh;
+  void refresh(bool partial_update_mode = false);
+
+private:
+  bool _fast;
+};
+
+#endif
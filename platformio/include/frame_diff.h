@@ -0,0 +1,66 @@
+/* Frame diff declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __FRAME_DIFF_H__
+#define __FRAME_DIFF_H__
+
+#include <cstdint>
+#include <vector>
+#include <Adafruit_GFX.h>
+#include "display_list.h"
+
+// Changes are tracked in tiles of one 32-bit word of a frame row by
+// FRAME_TILE_H rows.
+#define FRAME_TILE_W 32
+#define FRAME_TILE_H 16
+// The previous frame is kept in RTC memory if it fits into this many bytes
+// once compressed, or else in the data partition in flash.
+#define FRAME_RTC_BYTES  4096
+#define FRAME_FLASH_SLOT (16 * 1024)
+
+typedef dl_rect_t frame_rect_t;
+
+/* A band of rows of a 1 bit per pixel frame, in the same layout as the GxEPD2
+ * frame buffer (1 = white). Pixels outside the band are ignored.
+ */
+class FrameBand : public Adafruit_GFX {
+public:
+  FrameBand(int16_t w, int16_t h, int16_t rows);
+
+  void setTop(int16_t top) { _top = top; }
+  int16_t top() const { return _top; }
+  int16_t rows() const { return _rows; }
+  uint8_t *buffer() { return _buffer.data(); }
+  void replay(const DisplayList &list);
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+
+private:
+  int16_t _top;
+  int16_t _rows;
+  std::vector<uint8_t> _buffer;
+};
+
+bool frameDiff(const DisplayList &list, int16_t bandRows, size_t maxRects,
+               std::vector<frame_rect_t> &rects);
+bool frameUnchanged(const DisplayList &list, int16_t bandRows);
+bool frameReadPrevious(const frame_rect_t &r, uint8_t *dst);
+void frameSave(bool full);
+bool framePatch(const DisplayList &list, const frame_rect_t &r);
+uint32_t framePartialRefreshes();
+
+#endif
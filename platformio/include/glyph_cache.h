@@ -0,0 +1,55 @@
+/* Glyph cache for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __GLYPH_CACHE_H__
+#define __GLYPH_CACHE_H__
+
+#include <cstdint>
+#include <vector>
+#include <Adafruit_GFX.h>
+
+// DRAM set aside for glyphs, and the most glyphs kept. The dashboard uses
+// about 80 different glyphs, the 48pt temperature digits being the largest at
+// about 400 bytes each.
+#define GLYPH_CACHE_BYTES  (12 * 1024)
+#define GLYPH_CACHE_SLOTS  256
+
+/* Copies of font glyphs in DRAM, with each row starting on a byte, so that
+ * they can be blitted a byte at a time. The fonts store glyphs as one stream
+ * of bits, with rows starting anywhere in a byte.
+ *
+ * A glyph is converted the first time it is asked for and kept until the
+ * cache is destroyed. Once the cache is full, further glyphs are not cached.
+ */
+class GlyphCache {
+public:
+  GlyphCache();
+
+  const uint8_t *rows(const GFXfont *font, uint8_t c);
+
+private:
+  typedef struct slot {
+    const GFXfont *font;
+    uint32_t offset;
+    uint8_t c;
+  } slot_t;
+
+  std::vector<slot_t> _slots;
+  std::vector<uint8_t> _bytes;
+};
+
+#endif
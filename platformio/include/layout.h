@@ -0,0 +1,149 @@
+/* Screen layout for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __LAYOUT_H__
+#define __LAYOUT_H__
+
+#include <cstdint>
+#include "display_list.h"
+#include "renderer.h"
+
+/* Font a widget draws its text in, see setLayoutFont(). The fonts themselves
+ * are only included by the renderer.
+ */
+typedef enum layout_font : uint8_t
+{
+  LAYOUT_FONT_NONE,
+  LAYOUT_FONT_6PT,
+  LAYOUT_FONT_8PT,
+  LAYOUT_FONT_11PT,
+  LAYOUT_FONT_12PT,
+  LAYOUT_FONT_16PT,
+  LAYOUT_FONT_26PT,
+  LAYOUT_FONT_TEMPERATURE // 48pt, digits only
+} layout_font_t;
+
+/* Which screen a widget is drawn on. Widgets of the same screen never overlap.
+ */
+typedef enum layout_screen : uint8_t
+{
+  LAYOUT_SCREEN_WEATHER,
+  LAYOUT_SCREEN_ERROR
+} layout_screen_t;
+
+/* A widget owns the pixels of box and draws its text in font, aligned to the
+ * anchors the renderer derives from box.
+ */
+typedef struct layout_widget {
+  dl_rect_t box;
+  layout_font_t font;
+  alignment_t align;
+  layout_screen_t screen;
+} layout_widget_t;
+
+typedef enum layout_widget_id : uint8_t
+{
+  LAYOUT_CURRENT_ICON,
+  LAYOUT_CURRENT_TEMP,
+  LAYOUT_INDOOR_TEMP,
+  LAYOUT_INDOOR_HUMIDITY,
+  LAYOUT_HEADER,    // location and date, right aligned, and the clock
+  LAYOUT_FORECAST,  // one column per day
+  LAYOUT_OUTLOOK,   // graph, axis labels and hourly icons
+  LAYOUT_STATUS_BAR,
+  LAYOUT_ERROR_ICON,
+  LAYOUT_ERROR_MESSAGE,
+  LAYOUT_WIDGETS
+} layout_widget_id_t;
+
+#define LAYOUT_FORECAST_DAYS 5
+
+#if DISP_WIDTH == 800 && DISP_HEIGHT == 480
+constexpr layout_widget_t LAYOUT[LAYOUT_WIDGETS] = {
+  // LAYOUT_CURRENT_ICON
+  {{0, 0, 196, 196}, LAYOUT_FONT_NONE, LEFT, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_CURRENT_TEMP
+  {{196, 0, 164, 140}, LAYOUT_FONT_TEMPERATURE, CENTER, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_INDOOR_TEMP
+  {{196, 140, 82, 56}, LAYOUT_FONT_12PT, LEFT, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_INDOOR_HUMIDITY
+  {{278, 140, 82, 56}, LAYOUT_FONT_12PT, LEFT, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_HEADER
+  {{360, 0, 440, 60}, LAYOUT_FONT_16PT, RIGHT, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_FORECAST
+  {{388, 60, 410, 136}, LAYOUT_FONT_11PT, CENTER, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_OUTLOOK
+  {{0, 196, 800, 262}, LAYOUT_FONT_8PT, CENTER, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_STATUS_BAR
+  {{0, 458, 800, 22}, LAYOUT_FONT_6PT, RIGHT, LAYOUT_SCREEN_WEATHER},
+  // LAYOUT_ERROR_ICON
+  {{302, 121, 196, 196}, LAYOUT_FONT_NONE, LEFT, LAYOUT_SCREEN_ERROR},
+  // LAYOUT_ERROR_MESSAGE
+  {{100, 317, 600, 163}, LAYOUT_FONT_26PT, CENTER, LAYOUT_SCREEN_ERROR},
+};
+#else
+  #error No screen layout for this panel size, add one to layout.h.
+#endif
+
+constexpr int16_t layoutRight(const dl_rect_t &r) { return r.x + r.w; }
+constexpr int16_t layoutBottom(const dl_rect_t &r) { return r.y + r.h; }
+constexpr int16_t layoutCenterX(const dl_rect_t &r) { return r.x + r.w / 2; }
+constexpr int16_t layoutCenterY(const dl_rect_t &r) { return r.y + r.h / 2; }
+
+/* Returns column i of n equally wide columns of r.
+ */
+constexpr dl_rect_t layoutColumn(const dl_rect_t &r, uint8_t i, uint8_t n) {
+  return {static_cast<int16_t>(r.x + i * (r.w / n)), r.y,
+          static_cast<int16_t>(r.w / n), r.h};
+}
+
+constexpr bool layoutContains(const dl_rect_t &outer, const dl_rect_t &inner) {
+  return inner.x >= outer.x && inner.y >= outer.y
+         && layoutRight(inner) <= layoutRight(outer)
+         && layoutBottom(inner) <= layoutBottom(outer);
+}
+
+constexpr bool layoutOverlaps(const dl_rect_t &a, const dl_rect_t &b) {
+  return a.x < layoutRight(b) && b.x < layoutRight(a)
+         && a.y < layoutBottom(b) && b.y < layoutBottom(a);
+}
+
+/* Returns true if every widget has a box on the panel and no two widgets of a
+ * screen overlap.
+ */
+constexpr bool layoutValid() {
+  const dl_rect_t panel = {0, 0, DISP_WIDTH, DISP_HEIGHT};
+  for (uint8_t i = 0; i < LAYOUT_WIDGETS; ++i) {
+    if (LAYOUT[i].box.w <= 0 || LAYOUT[i].box.h <= 0
+        || !layoutContains(panel, LAYOUT[i].box)) {
+      return false;
+    }
+    for (uint8_t j = 0; j < i; ++j) {
+      if (LAYOUT[i].screen == LAYOUT[j].screen
+          && layoutOverlaps(LAYOUT[i].box, LAYOUT[j].box)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static_assert(layoutValid(), "widgets must fit the panel and not overlap");
+static_assert(LAYOUT[LAYOUT_FORECAST].box.w % LAYOUT_FORECAST_DAYS == 0,
+              "forecast columns must be equally wide");
+
+#endif
@@ -0,0 +1,43 @@
+/* Power management declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __POWER_UTILS_H__
+#define __POWER_UTILS_H__
+
+#include <cstdint>
+
+typedef enum wake_phase
+{
+  PHASE_BOOT,
+  PHASE_NETWORK,
+  PHASE_PARSE,
+  PHASE_SENSOR,
+  PHASE_RENDER,
+  PHASE_DISPLAY,
+  PHASE_COUNT
+} wake_phase_t;
+
+void enterPhase(wake_phase_t phase);
+wake_phase_t currentPhase();
+uint32_t getPhaseFrequency(wake_phase_t phase);
+uint64_t getPhaseMicros(wake_phase_t phase);
+const char *getPhaseName(wake_phase_t phase);
+void setAutoLightSleep(bool enable);
+uint64_t getLightSleepMicros();
+void printPhaseStats();
+
+#endif
@@ -23,34 +23,41 @@
 #include <time.h>
 #include "api_response.h"
 #include "config.h"
+#include "display_list.h"
 
 #ifdef DISP_BW_V2
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750_T7,
-                   GxEPD2_750_T7::HEIGHT> display;
+  #include "epd_fast_refresh.h"
+  // 8000 byte page buffer, frames are replayed into it from a DisplayList
+  typedef GxEPD2_BW<GxEPD2_750_T7_Fast,
+                    GxEPD2_750_T7_Fast::HEIGHT / 6> display_t;
+  extern display_t display;
 #endif
 #ifdef DISP_3C_B
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_3C.h>
-  extern GxEPD2_3C<GxEPD2_750c_Z08,
-                   GxEPD2_750c_Z08::HEIGHT / 2> display;
+  typedef GxEPD2_3C<GxEPD2_750c_Z08,
+                    GxEPD2_750c_Z08::HEIGHT / 2> display_t;
+  extern display_t display;
 #endif
 #ifdef DISP_7C_F
   #define DISP_WIDTH  800
   #define DISP_HEIGHT 480
   #include <GxEPD2_7C.h>
-  extern GxEPD2_7C<GxEPD2_730c_GDEY073D46, 
-                   GxEPD2_730c_GDEY073D46::HEIGHT / 4> display;
+  typedef GxEPD2_7C<GxEPD2_730c_GDEY073D46,
+                    GxEPD2_730c_GDEY073D46::HEIGHT / 4> display_t;
+  extern display_t display;
 #endif
 #ifdef DISP_BW_V1
   #define DISP_WIDTH  640
   #define DISP_HEIGHT 384
   #include <GxEPD2_BW.h>
-  extern GxEPD2_BW<GxEPD2_750,
-                   GxEPD2_750::HEIGHT> display;
+  typedef GxEPD2_BW<GxEPD2_750,
+                    GxEPD2_750::HEIGHT> display_t;
+  extern display_t display;
 #endif
 
 typedef enum alignment
@@ -60,6 +67,8 @@ typedef enum alignment
   CENTER
 } alignment_t;
 
+void setRenderTarget(DisplayList *target);
+DisplayList &renderTarget();
 uint16_t getStringWidth(const String &text);
 uint16_t getStringHeight(const String &text);
 void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
@@ -69,12 +78,22 @@ void drawMultiLnString(int16_t x, int16_t y, const String &text,
                        uint16_t max_lines, int16_t line_spacing,
                        uint16_t color=GxEPD_BLACK);
 void initDisplay();
+void beginFrame();
+void drawFrame(display_t &frame);
+bool displayUnchanged();
+void refreshDisplay(float temperature=NAN);
+void refreshDisplayAsync(float temperature=NAN);
+void waitRefreshDone();
+bool refreshClock(const tm &timeInfo);
+bool displayShowsClock();
 void powerOffDisplay();
+void drawBackground();
 void drawCurrentConditions(const dwd_current_t &current,
                            const dwd_daily_t &today,
                            float inTemp, float inHumidity);
 void drawForecast(const dwd_daily_t *daily, tm timeInfo);
 void drawLocationDate(const String &city, const String &date);
+void drawClock(const tm &timeInfo);
 void drawOutlookGraph(const dwd_hourly_t *hourly, const dwd_daily_t *daily,
                       tm timeInfo);
 void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
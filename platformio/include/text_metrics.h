@@ -0,0 +1,72 @@
+/* Text metrics for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __TEXT_METRICS_H__
+#define __TEXT_METRICS_H__
+
+#include <cstdint>
+#include <Adafruit_GFX.h>
+
+// strings up to this long are cached, longer ones are measured every time
+#define TEXT_CACHE_ENTRIES 16
+#define TEXT_CACHE_LEN     32
+
+/* Bounding box of a string, relative to the cursor it is printed at.
+ */
+typedef struct text_bounds {
+  int16_t x;
+  int16_t y;
+  uint16_t w;
+  uint16_t h;
+} text_bounds_t;
+
+/* A line broken off the start of a text, see breakLine().
+ */
+typedef struct text_line {
+  uint16_t len;   // characters of the text on this line
+  uint16_t width; // as getTextBounds() measures it, with the ellipsis
+  bool ellipsis;  // "..." follows, the text was cut short
+  uint16_t next;  // where the next line starts
+} text_line_t;
+
+text_bounds_t measureText(const GFXfont *font, const char *text);
+text_line_t breakLine(const GFXfont *font, const char *text,
+                      uint16_t maxWidth, bool last);
+
+/* The bounds of the most recently measured strings. Most strings are
+ * measured more than once, e.g. for alignment and then again to place
+ * whatever is next to them.
+ */
+class TextCache {
+public:
+  TextCache();
+
+  text_bounds_t measure(const GFXfont *font, const char *text);
+
+private:
+  typedef struct entry {
+    const GFXfont *font;
+    uint32_t lastUse;
+    text_bounds_t bounds;
+    char text[TEXT_CACHE_LEN];
+  } entry_t;
+
+  entry_t _entries[TEXT_CACHE_ENTRIES];
+  uint32_t _tick;
+};
+
+#endif
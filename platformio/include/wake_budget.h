@@ -0,0 +1,33 @@
+/* Wake budget declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WAKE_BUDGET_H__
+#define __WAKE_BUDGET_H__
+
+#include <cstdint>
+#include "power_utils.h"
+
+uint32_t budgetRemainingMs();
+float budgetChargeUsed();
+uint32_t budgetClampTimeout(uint32_t timeoutMs);
+bool budgetAllows(uint32_t ms);
+bool budgetExhausted();
+void budgetSaveDiagnostics();
+void budgetPrintDiagnostics();
+void budgetPrintStats();
+
+#endif
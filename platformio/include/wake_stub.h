@@ -0,0 +1,32 @@
+/* Deep-sleep wake stub declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WAKE_STUB_H__
+#define __WAKE_STUB_H__
+
+#include <cstdint>
+
+// Maximum number of consecutive wakes the stub can absorb before the
+// application must boot again. Each slot costs 8 bytes of RTC slow memory.
+#define WAKE_STUB_MAX_SLOTS 24
+
+void wakeStubClear();
+bool wakeStubAddSkip(uint64_t sleepSeconds);
+uint32_t wakeStubSlots();
+uint32_t wakeStubSkippedWakes();
+
+#endif
@@ -0,0 +1,75 @@
+/* Widget render cache declarations for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WIDGET_CACHE_H__
+#define __WIDGET_CACHE_H__
+
+#include <cstdint>
+#include <cstring>
+#include <Arduino.h>
+#include "display_list.h"
+#include "layout.h"
+
+/* Widgets that are copied from the frame on the panel while their inputs stay
+ * the same, see widgetCacheDraw().
+ */
+typedef enum widget_cache_slot : uint8_t
+{
+  WIDGET_LOCATION,
+  WIDGET_INDOOR_TEMP,
+  WIDGET_INDOOR_HUMIDITY,
+  WIDGET_FORECAST, // one slot per day
+  WIDGET_CACHE_SLOTS = WIDGET_FORECAST + LAYOUT_FORECAST_DAYS
+} widget_cache_slot_t;
+
+/* 32-bit FNV-1a hash of a widget's inputs, a word at a time.
+ */
+class WidgetHash {
+public:
+  WidgetHash() : _hash(2166136261u) {}
+
+  WidgetHash &add(uint32_t word) {
+    _hash = (_hash ^ word) * 16777619u;
+    return *this;
+  }
+  WidgetHash &add(float value) {
+    uint32_t word;
+    memcpy(&word, &value, sizeof(word));
+    return add(word);
+  }
+  WidgetHash &add(const String &text) {
+    add(static_cast<uint32_t>(text.length()));
+    for (unsigned int i = 0; i < text.length(); ++i) {
+      add(static_cast<uint32_t>(static_cast<uint8_t>(text[i])));
+    }
+    return *this;
+  }
+  uint32_t value() const { return _hash; }
+
+private:
+  uint32_t _hash;
+};
+
+void widgetCacheBegin();
+bool widgetCacheDraw(DisplayList &gfx, widget_cache_slot_t slot, uint32_t hash,
+                     int16_t &value);
+void widgetCacheAdd(const DisplayList &gfx, widget_cache_slot_t slot,
+                    uint32_t hash, size_t first, int16_t value = 0);
+void widgetCacheSave(const DisplayList *list, size_t background);
+void widgetCacheReport();
+
+#endif
@@ -0,0 +1,42 @@
+/* Host BME280 shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __ADAFRUIT_BME280_H__
+#define __ADAFRUIT_BME280_H__
+
+#include <cstdint>
+
+#include "Wire.h"
+
+#define BME280_ADDRESS           (0x77)
+#define BME280_ADDRESS_ALTERNATE (0x76)
+
+/* Simulated BME280, readings are set with NATIVE_BME_TEMP and
+ * NATIVE_BME_HUMIDITY. With NATIVE_BME=absent the sensor is not found.
+ */
+class Adafruit_BME280 {
+public:
+  bool begin(uint8_t addr = BME280_ADDRESS, TwoWire *theWire = &Wire);
+  float readTemperature();
+  float readPressure();
+  float readHumidity();
+  float readAltitude(float seaLevel);
+
+private:
+  bool _found = false;
+};
+
+#endif
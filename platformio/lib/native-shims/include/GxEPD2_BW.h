@@ -0,0 +1,284 @@
+/* Host GxEPD2 shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __GXEPD2_BW_H__
+#define __GXEPD2_BW_H__
+
+#include <cstring>
+#include <utility>
+
+#include "Adafruit_GFX.h"
+#include "GxEPD2.h"
+#include "GxEPD2_EPD.h"
+#include "epd/GxEPD2_750_T7.h"
+
+/* Paged black/white frame buffer, with the same drawing, paging and partial
+ * window behaviour as GxEPD2_BW.
+ */
+template <typename GxEPD2_Type, const uint16_t page_height>
+class GxEPD2_BW : public Adafruit_GFX {
+public:
+  GxEPD2_Type epd2;
+
+  GxEPD2_BW(GxEPD2_Type epd2_instance)
+      : Adafruit_GFX(GxEPD2_Type::WIDTH_VISIBLE, GxEPD2_Type::HEIGHT),
+        epd2(epd2_instance) {
+    _page_height = page_height;
+    _pages = (HEIGHT / _page_height) + ((HEIGHT % _page_height) > 0);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  uint16_t pages() { return _pages; }
+  uint16_t pageHeight() { return _page_height; }
+  bool mirror(bool m) { return _mirror = m; }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || x >= width() || y < 0 || y >= height()) {
+      return;
+    }
+    if (_mirror) {
+      x = width() - x - 1;
+    }
+    switch (getRotation()) {
+    case 1:
+      std::swap(x, y);
+      x = GxEPD2_Type::WIDTH - x - 1;
+      break;
+    case 2:
+      x = GxEPD2_Type::WIDTH - x - 1;
+      y = GxEPD2_Type::HEIGHT - y - 1;
+      break;
+    case 3:
+      std::swap(x, y);
+      y = GxEPD2_Type::HEIGHT - y - 1;
+      break;
+    }
+    // adjust for current partial window
+    if (_using_partial_mode) {
+      if (x < _pw_x || x >= _pw_x + _pw_w || y < _pw_y
+          || y >= _pw_y + _pw_h) {
+        return;
+      }
+      x -= _pw_x;
+      y -= _pw_y;
+    }
+    // adjust for current page
+    y -= _current_page * _page_height;
+    if (y < 0 || y >= _page_height) {
+      return;
+    }
+    uint16_t i = x / 8 + y * (_pw_w / 8);
+    if (color) {
+      _buffer[i] = _buffer[i] | (1 << (7 - x % 8));
+    } else {
+      _buffer[i] = _buffer[i] & (0xFF ^ (1 << (7 - x % 8)));
+    }
+  }
+
+  void init(uint32_t serial_diag_bitrate = 0) {
+    epd2.init(serial_diag_bitrate);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false) {
+    epd2.init(serial_diag_bitrate, initial, reset_duration,
+              pulldown_rst_mode);
+    _using_partial_mode = false;
+    _current_page = 0;
+    setFullWindow();
+  }
+
+  void fillScreen(uint16_t color) override {
+    uint8_t data = color ? 0xFF : 0x00;
+    memset(_buffer, data, sizeof(_buffer));
+  }
+
+  // display buffer content to screen, useful for full screen buffer
+  void display(bool partial_update_mode = false) {
+    if (partial_update_mode) {
+      epd2.writeImage(_buffer, 0, 0, GxEPD2_Type::WIDTH, _page_height);
+      epd2.refresh(0, 0, GxEPD2_Type::WIDTH, _page_height);
+      epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, _page_height);
+    } else {
+      epd2.writeImageForFullRefresh(_buffer, 0, 0, GxEPD2_Type::WIDTH,
+                                    _page_height);
+      epd2.refresh(false);
+      epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH, _page_height);
+      epd2.powerOff();
+    }
+  }
+
+  void setFullWindow() {
+    _using_partial_mode = false;
+    _pw_x = 0;
+    _pw_y = 0;
+    _pw_w = GxEPD2_Type::WIDTH;
+    _pw_h = GxEPD2_Type::HEIGHT;
+  }
+
+  void setPartialWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    _pw_x = std::min<int16_t>(x, width());
+    _pw_y = std::min<int16_t>(y, height());
+    _pw_w = std::min<int16_t>(w, width() - _pw_x);
+    _pw_h = std::min<int16_t>(h, height() - _pw_y);
+    _rotate(_pw_x, _pw_y, _pw_w, _pw_h);
+    _using_partial_mode = true;
+    // make _pw_x, _pw_w multiple of 8
+    _pw_w += _pw_x % 8;
+    if (_pw_w % 8 > 0) {
+      _pw_w += 8 - _pw_w % 8;
+    }
+    _pw_x -= _pw_x % 8;
+  }
+
+  void firstPage() {
+    fillScreen(GxEPD_WHITE);
+    _current_page = 0;
+    _second_phase = false;
+  }
+
+  bool nextPage() {
+    if (1 == _pages) {
+      if (_using_partial_mode) {
+        epd2.writeImage(_buffer, _pw_x, _pw_y, _pw_w, _pw_h);
+        epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+        epd2.writeImageAgain(_buffer, _pw_x, _pw_y, _pw_w, _pw_h);
+      } else { // full update
+        epd2.writeImageForFullRefresh(_buffer, 0, 0, GxEPD2_Type::WIDTH,
+                                      GxEPD2_Type::HEIGHT);
+        epd2.refresh(false);
+        epd2.writeImageAgain(_buffer, 0, 0, GxEPD2_Type::WIDTH,
+                             GxEPD2_Type::HEIGHT);
+        epd2.powerOff();
+      }
+      return false;
+    }
+    uint16_t page_ys = _current_page * _page_height;
+    if (_using_partial_mode) {
+      uint16_t page_ye = _current_page < (_pages - 1)
+                             ? page_ys + _page_height
+                             : GxEPD2_Type::HEIGHT;
+      uint16_t dest_ys = _pw_y + page_ys; // transposed
+      int16_t page_h = std::min<int16_t>(page_ye - page_ys, _pw_h - page_ys);
+      if (page_h > 0) {
+        epd2.writeImage(_buffer, _pw_x, dest_ys, _pw_w, page_h);
+      }
+      _current_page++;
+      if (_current_page == _pages || page_ys + page_h >= _pw_h) {
+        _current_page = 0;
+        if (!_second_phase) {
+          epd2.refresh(_pw_x, _pw_y, _pw_w, _pw_h);
+          _second_phase = true;
+          fillScreen(GxEPD_WHITE);
+          return true;
+        }
+        return false;
+      }
+      fillScreen(GxEPD_WHITE);
+      return true;
+    }
+    // full window, paged
+    uint16_t page_ye = _current_page < (_pages - 1) ? page_ys + _page_height
+                                                    : GxEPD2_Type::HEIGHT;
+    uint16_t page_h = page_ye - page_ys;
+    if (_second_phase) {
+      epd2.writeImageAgain(_buffer, 0, page_ys, GxEPD2_Type::WIDTH, page_h);
+    } else {
+      epd2.writeImageForFullRefresh(_buffer, 0, page_ys, GxEPD2_Type::WIDTH,
+                                    page_h);
+    }
+    _current_page++;
+    if (_current_page == _pages) {
+      _current_page = 0;
+      if (!_second_phase) {
+        epd2.refresh(false);
+        if (GxEPD2_Type::hasFastPartialUpdate) {
+          // write the image again, so that partial updates have the right
+          // previous image
+          _second_phase = true;
+          fillScreen(GxEPD_WHITE);
+          return true;
+        }
+      }
+      epd2.powerOff();
+      return false;
+    }
+    fillScreen(GxEPD_WHITE);
+    return true;
+  }
+
+  // bitmap bits 0 are drawn in color, like GxEPD2
+  void drawInvertedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                          int16_t w, int16_t h, uint16_t color,
+                          bool pgm = true) {
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t byte = 0;
+    for (int16_t j = 0; j < h; j++) {
+      for (int16_t i = 0; i < w; i++) {
+        if (i & 7) {
+          byte <<= 1;
+        } else {
+          byte = bitmap[j * byteWidth + i / 8];
+        }
+        if (!(byte & 0x80)) {
+          drawPixel(x + i, y + j, color);
+        }
+      }
+    }
+  }
+
+  void powerOff() { epd2.powerOff(); }
+  void hibernate() { epd2.hibernate(); }
+
+private:
+  void _rotate(int16_t &x, int16_t &y, int16_t &w, int16_t &h) {
+    switch (getRotation()) {
+    case 1:
+      std::swap(x, y);
+      std::swap(w, h);
+      x = GxEPD2_Type::WIDTH - x - w;
+      break;
+    case 2:
+      x = GxEPD2_Type::WIDTH - x - w;
+      y = GxEPD2_Type::HEIGHT - y - h;
+      break;
+    case 3:
+      std::swap(x, y);
+      std::swap(w, h);
+      y = GxEPD2_Type::HEIGHT - y - h;
+      break;
+    }
+  }
+
+  uint8_t _buffer[(GxEPD2_Type::WIDTH / 8) * page_height];
+  bool _using_partial_mode;
+  bool _second_phase;
+  bool _mirror = false;
+  int16_t _current_page;
+  uint16_t _pages;
+  uint16_t _page_height;
+  int16_t _pw_x;
+  int16_t _pw_y;
+  int16_t _pw_w;
+  int16_t _pw_h;
+};
+
+#endif
@@ -0,0 +1,127 @@
+/* Host GxEPD2 shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __GXEPD2_EPD_H__
+#define __GXEPD2_EPD_H__
+
+#include <cstdint>
+#include <vector>
+
+#include "Arduino.h"
+#include "GxEPD2.h"
+#include "SPI.h"
+
+/* Simulated panel controller. The controller RAM and the image currently shown
+ * on the panel are kept as 1 bit per pixel frames (1 = white), in the same
+ * layout as the GxEPD2 frame buffer.
+ *
+ * A partial refresh only drives the pixels that differ between the previous
+ * and the new image in controller RAM, like the differential waveform of the
+ * real controller. Controller RAM does not survive hibernation. After
+ * init(..., initial = true) the first refresh is always a full refresh, as in
+ * GxEPD2.
+ *
+ * The controller picks the full refresh waveform by the panel temperature,
+ * which can be forced with the cascade setting (0xE0, TSFIX) and force
+ * temperature (0xE5) commands. From 40C on the shorter high temperature
+ * waveform is used, which takes about 40% as long.
+ *
+ * Refreshes drive the BUSY pin like the real panel does. By default the busy
+ * period ends immediately. Set NATIVE_EPD_BUSY=1 to make it last as long as
+ * the panel's (approximate) refresh time.
+ */
+class GxEPD2_EPD {
+public:
+  const uint16_t WIDTH;
+  const uint16_t HEIGHT;
+  const bool hasPartialUpdate;
+  const bool hasFastPartialUpdate;
+
+  GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy,
+             int16_t busy_level, uint32_t busy_timeout, uint16_t w,
+             uint16_t h, bool partial, bool fast_partial,
+             uint16_t full_refresh_time, uint16_t partial_refresh_time);
+  GxEPD2_EPD(const GxEPD2_EPD &other);
+  virtual ~GxEPD2_EPD();
+
+  void init(uint32_t serial_diag_bitrate = 0);
+  void init(uint32_t serial_diag_bitrate, bool initial,
+            uint16_t reset_duration = 10, bool pulldown_rst_mode = false);
+  void setBusyCallback(void (*busyCallback)(const void *),
+                       const void *busy_callback_parameter = 0);
+
+  void clearScreen(uint8_t value = 0xFF);
+  void writeScreenBuffer(uint8_t value = 0xFF);
+  void writeImage(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w,
+                  int16_t h, bool invert = false, bool mirror_y = false,
+                  bool pgm = false);
+  void writeImageForFullRefresh(const uint8_t bitmap[], int16_t x, int16_t y,
+                                int16_t w, int16_t h, bool invert = false,
+                                bool mirror_y = false, bool pgm = false);
+  void writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y,
+                       int16_t w, int16_t h, bool invert = false,
+                       bool mirror_y = false, bool pgm = false);
+  void writeImagePrevious(const uint8_t bitmap[], int16_t x, int16_t y,
+                          int16_t w, int16_t h, bool invert = false,
+                          bool mirror_y = false, bool pgm = false);
+  void writeImageNew(const uint8_t bitmap[], int16_t x, int16_t y, int16_t w,
+                     int16_t h, bool invert = false, bool mirror_y = false,
+                     bool pgm = false);
+  void refresh(bool partial_update_mode = false);
+  void refresh(int16_t x, int16_t y, int16_t w, int16_t h);
+  void powerOff();
+  void hibernate();
+
+  // host only
+  const uint8_t *panel() const { return _panel.data(); }
+  uint32_t fullRefreshes() const { return _full_refreshes; }
+  uint32_t partialRefreshes() const { return _partial_refreshes; }
+  uint32_t fastRefreshes() const { return _fast_refreshes; }
+  bool savePanel(const char *prefix) const;
+  static bool saveAll(const char *prefix);
+
+protected:
+  void _writeRam(std::vector<uint8_t> &ram, const uint8_t bitmap[], int16_t x,
+                 int16_t y, int16_t w, int16_t h, bool invert, bool mirror_y);
+  void _showRam(int16_t x, int16_t y, int16_t w, int16_t h, bool partial);
+  void _waitWhileBusy(const char *comment, uint16_t busy_time);
+  void _writeCommand(uint8_t c);
+  void _writeData(uint8_t d);
+
+  int16_t _busy;
+  int16_t _busy_level;
+  uint32_t _busy_timeout;
+  uint16_t _full_refresh_time;
+  uint16_t _partial_refresh_time;
+  bool _power_is_on;
+  bool _hibernating;
+  bool _initial_write;
+  bool _initial_refresh;
+  uint8_t _command;
+  uint8_t _cascade;
+  uint8_t _forced_temperature;
+  void (*_busy_callback)(const void *);
+  const void *_busy_callback_parameter;
+
+  std::vector<uint8_t> _ram;      // controller RAM, the next image
+  std::vector<uint8_t> _previous; // controller RAM, the current image
+  std::vector<uint8_t> _panel;    // what the panel actually shows
+  uint32_t _full_refreshes;
+  uint32_t _partial_refreshes;
+  uint32_t _fast_refreshes;
+};
+
+#endif
@@ -0,0 +1,41 @@
+/* Host serial port shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __HARDWARE_SERIAL_H__
+#define __HARDWARE_SERIAL_H__
+
+#include "Stream.h"
+
+/* Serial writes to stdout and never receives anything.
+ */
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) {}
+  void end() {}
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,72 @@
+/* Host Print shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __PRINT_H__
+#define __PRINT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+
+#include "WString.h"
+
+class Print {
+public:
+  virtual ~Print() = default;
+
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *str);
+  size_t write(const char *buffer, size_t size) {
+    return write(reinterpret_cast<const uint8_t *>(buffer), size);
+  }
+  virtual void flush() {}
+
+  size_t printf(const char *format, ...)
+      __attribute__((format(printf, 2, 3)));
+
+  size_t print(const __FlashStringHelper *str);
+  size_t print(const String &str);
+  size_t print(const char str[]);
+  size_t print(char c);
+  size_t print(unsigned char value, int base = DEC);
+  size_t print(int value, int base = DEC);
+  size_t print(unsigned int value, int base = DEC);
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(long long value, int base = DEC);
+  size_t print(unsigned long long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+  size_t print(const struct tm *timeinfo, const char *format = nullptr);
+
+  size_t println(const __FlashStringHelper *str);
+  size_t println(const String &str);
+  size_t println(const char str[]);
+  size_t println(char c);
+  size_t println(unsigned char value, int base = DEC);
+  size_t println(int value, int base = DEC);
+  size_t println(unsigned int value, int base = DEC);
+  size_t println(long value, int base = DEC);
+  size_t println(unsigned long value, int base = DEC);
+  size_t println(long long value, int base = DEC);
+  size_t println(unsigned long long value, int base = DEC);
+  size_t println(double value, int digits = 2);
+  size_t println(const struct tm *timeinfo, const char *format = nullptr);
+  size_t println();
+};
+
+#endif
@@ -0,0 +1,60 @@
+/* Host Stream shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __STREAM_H__
+#define __STREAM_H__
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  unsigned long getTimeout() const { return _timeout; }
+
+  /* Reads up to length bytes. There is no waiting on the host, a stream that
+   * runs dry has ended.
+   */
+  virtual size_t readBytes(char *buffer, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) {
+      buffer[n++] = static_cast<char>(c);
+    }
+    return n;
+  }
+  size_t readBytes(uint8_t *buffer, size_t length) {
+    return readBytes(reinterpret_cast<char *>(buffer), length);
+  }
+
+  String readString() {
+    String s;
+    int c;
+    while ((c = read()) >= 0) {
+      s += static_cast<char>(c);
+    }
+    return s;
+  }
+
+protected:
+  unsigned long _timeout = 1000;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/* Host String shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WSTRING_H__
+#define __WSTRING_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(string_literal) \
+  (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+/* Arduino String backed by std::string. Only the parts of the Arduino API in
+ * use by this project and its libraries are provided.
+ */
+class String {
+public:
+  String(const char *cstr = "");
+  String(const char *cstr, unsigned int length);
+  String(const __FlashStringHelper *str);
+  String(const std::string &str) : s(str) {}
+  String(const String &) = default;
+  String(String &&) = default;
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = DEC);
+  explicit String(int value, unsigned char base = DEC);
+  explicit String(unsigned int value, unsigned char base = DEC);
+  explicit String(long value, unsigned char base = DEC);
+  explicit String(unsigned long value, unsigned char base = DEC);
+  explicit String(long long value, unsigned char base = DEC);
+  explicit String(unsigned long long value, unsigned char base = DEC);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+
+  String &operator=(const String &) = default;
+  String &operator=(String &&) = default;
+  String &operator=(const char *cstr);
+
+  unsigned int length() const { return s.length(); }
+  bool isEmpty() const { return s.empty(); }
+  const char *c_str() const { return s.c_str(); }
+  bool reserve(unsigned int size);
+
+  bool concat(const String &str);
+  bool concat(const char *cstr);
+  bool concat(const char *cstr, unsigned int length);
+  bool concat(char c);
+  bool concat(unsigned char value);
+  bool concat(int value);
+  bool concat(unsigned int value);
+  bool concat(long value);
+  bool concat(unsigned long value);
+  bool concat(long long value);
+  bool concat(unsigned long long value);
+  bool concat(float value);
+  bool concat(double value);
+
+  template <typename T> String &operator+=(const T &rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  int compareTo(const String &str) const;
+  bool equals(const String &str) const { return s == str.s; }
+  bool equals(const char *cstr) const;
+  bool equalsIgnoreCase(const String &str) const;
+  bool operator==(const String &rhs) const { return equals(rhs); }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String &rhs) const { return !equals(rhs); }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool operator<(const String &rhs) const { return compareTo(rhs) < 0; }
+  bool operator>(const String &rhs) const { return compareTo(rhs) > 0; }
+  bool operator<=(const String &rhs) const { return compareTo(rhs) <= 0; }
+  bool operator>=(const String &rhs) const { return compareTo(rhs) >= 0; }
+  bool startsWith(const String &prefix) const;
+  bool startsWith(const String &prefix, unsigned int offset) const;
+  bool endsWith(const String &suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char &operator[](unsigned int index);
+  void getBytes(unsigned char *buf, unsigned int bufsize,
+                unsigned int index = 0) const;
+  void toCharArray(char *buf, unsigned int bufsize,
+                   unsigned int index = 0) const;
+  const char *begin() const { return c_str(); }
+  const char *end() const { return c_str() + length(); }
+
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String &str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char ch) const;
+  int lastIndexOf(char ch, unsigned int fromIndex) const;
+  int lastIndexOf(const String &str) const;
+  int lastIndexOf(const String &str, unsigned int fromIndex) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void replace(const String &find, const String &replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  std::string s;
+};
+
+/* Result type of String concatenation, kept for compatibility with libraries
+ * that test for it.
+ */
+class StringSumHelper : public String {
+public:
+  using String::String;
+  StringSumHelper(const String &s) : String(s) {}
+};
+
+StringSumHelper operator+(const String &lhs, const String &rhs);
+StringSumHelper operator+(const String &lhs, const char *rhs);
+StringSumHelper operator+(const char *lhs, const String &rhs);
+StringSumHelper operator+(const String &lhs, char rhs);
+StringSumHelper operator+(char lhs, const String &rhs);
+StringSumHelper operator+(const String &lhs, int rhs);
+StringSumHelper operator+(const String &lhs, unsigned int rhs);
+StringSumHelper operator+(const String &lhs, long rhs);
+StringSumHelper operator+(const String &lhs, unsigned long rhs);
+StringSumHelper operator+(const String &lhs, float rhs);
+StringSumHelper operator+(const String &lhs, double rhs);
+
+#endif
@@ -0,0 +1,107 @@
+/* Host WiFi shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __WIFI_H__
+#define __WIFI_H__
+
+#include <cstdint>
+#include <functional>
+
+#include "WString.h"
+#include "WiFiClient.h"
+
+typedef enum {
+  WL_NO_SHIELD = 255,
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum {
+  WIFI_MODE_NULL = 0,
+  WIFI_MODE_STA,
+  WIFI_MODE_AP,
+  WIFI_MODE_APSTA,
+} wifi_mode_t;
+
+#define WIFI_OFF   WIFI_MODE_NULL
+#define WIFI_STA   WIFI_MODE_STA
+#define WIFI_AP    WIFI_MODE_AP
+#define WIFI_AP_STA WIFI_MODE_APSTA
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_READY = 0,
+  ARDUINO_EVENT_WIFI_STA_START,
+  ARDUINO_EVENT_WIFI_STA_STOP,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_MAX,
+} arduino_event_id_t;
+
+typedef union {
+  uint32_t reserved;
+} arduino_event_info_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+typedef arduino_event_info_t WiFiEventInfo_t;
+typedef size_t wifi_event_id_t;
+typedef std::function<void(arduino_event_id_t, arduino_event_info_t)>
+    WiFiEventFuncCb;
+
+class IPAddress {
+public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0)
+      : _addr{a, b, c, d} {}
+  String toString() const;
+  uint8_t operator[](int i) const { return _addr[i]; }
+
+private:
+  uint8_t _addr[4];
+};
+
+/* Simulated station. Whether connecting succeeds is set with NATIVE_WIFI, and
+ * events are delivered synchronously from begin().
+ */
+class WiFiClass {
+public:
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr);
+  bool disconnect(bool wifioff = false, bool eraseap = false);
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode() { return _mode; }
+  wl_status_t status() { return _status; }
+  int8_t RSSI();
+  IPAddress localIP();
+
+  wifi_event_id_t onEvent(WiFiEventFuncCb cb,
+                          arduino_event_id_t event = ARDUINO_EVENT_MAX);
+  void removeEvent(wifi_event_id_t id);
+
+private:
+  void raise(arduino_event_id_t event);
+
+  wl_status_t _status = WL_IDLE_STATUS;
+  wifi_mode_t _mode = WIFI_MODE_NULL;
+};
+
+extern WiFiClass WiFi;
+
+#endif
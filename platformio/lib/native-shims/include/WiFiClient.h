@@ -0,0 +1,52 @@
+/* Host WiFiClient shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __WIFI_CLIENT_H__
+#define __WIFI_CLIENT_H__
+
+#include <string>
+
+#include "Stream.h"
+
+/* A client whose receive buffer is filled by HTTPClient. Anything written to
+ * it is discarded.
+ */
+class WiFiClient : public Stream {
+public:
+  virtual ~WiFiClient() = default;
+
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t readBytes(char *buffer, size_t length) override;
+  using Stream::readBytes;
+  size_t write(uint8_t c) override { return 1; }
+  size_t write(const uint8_t *buffer, size_t size) override { return size; }
+  using Print::write;
+
+  void stop();
+  uint8_t connected() { return _pos < _rx.size(); }
+  operator bool() { return connected(); }
+
+  // used by HTTPClient
+  void setReceived(std::string data);
+
+private:
+  std::string _rx;
+  size_t _pos = 0;
+};
+
+#endif
@@ -0,0 +1,34 @@
+/* Host I2C shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __WIRE_H__
+#define __WIRE_H__
+
+#include <cstdint>
+
+// There is no I2C bus on the host, simulated devices don't need one.
+class TwoWire {
+public:
+  TwoWire(uint8_t bus_num = 0) {}
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    return true;
+  }
+  bool end() { return true; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,43 @@
+/* Host GxEPD2 shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __GXEPD2_750_T7_H__
+#define __GXEPD2_750_T7_H__
+
+#include "../GxEPD2_EPD.h"
+
+/* Good Display GDEW075T7, 7.5" 800x480 black/white.
+ */
+class GxEPD2_750_T7 : public GxEPD2_EPD {
+public:
+  static const uint16_t WIDTH = 800;
+  static const uint16_t WIDTH_VISIBLE = WIDTH;
+  static const uint16_t HEIGHT = 480;
+  static const bool hasColor = false;
+  static const bool hasPartialUpdate = true;
+  static const bool hasFastPartialUpdate = true;
+  static const uint16_t power_on_time = 200;         // ms
+  static const uint16_t power_off_time = 50;         // ms
+  static const uint16_t full_refresh_time = 4000;    // ms
+  static const uint16_t partial_refresh_time = 1700; // ms
+
+  GxEPD2_750_T7(int16_t cs, int16_t dc, int16_t rst, int16_t busy)
+      : GxEPD2_EPD(cs, dc, rst, busy, LOW, 10000000, WIDTH, HEIGHT,
+                   hasPartialUpdate, hasFastPartialUpdate, full_refresh_time,
+                   partial_refresh_time) {}
+};
+
+#endif
@@ -0,0 +1,32 @@
+/* Host ESP-IDF shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __ESP_ATTR_H__
+#define __ESP_ATTR_H__
+
+// There are no separate memory regions on the host. RTC memory therefore does
+// not survive "deep sleep", which ends the process anyway.
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_RODATA_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_FAST_ATTR
+#define RTC_SLOW_ATTR
+#define NOINIT_ATTR
+
+#endif
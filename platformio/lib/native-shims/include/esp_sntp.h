@@ -0,0 +1,35 @@
+/* Host ESP-IDF shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __ESP_SNTP_H__
+#define __ESP_SNTP_H__
+
+#include <sys/time.h>
+
+typedef enum {
+  SNTP_SYNC_STATUS_RESET,
+  SNTP_SYNC_STATUS_COMPLETED,
+  SNTP_SYNC_STATUS_IN_PROGRESS,
+} sntp_sync_status_t;
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval *tv);
+
+// The host clock is assumed to be synchronized already, so the status is
+// SNTP_SYNC_STATUS_COMPLETED as soon as configTzTime() has been called.
+sntp_sync_status_t sntp_get_sync_status();
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+
+#endif
@@ -0,0 +1,38 @@
+/* Host FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __FREERTOS_EVENT_GROUPS_H__
+#define __FREERTOS_EVENT_GROUPS_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct NativeEventGroup *EventGroupHandle_t;
+typedef TickType_t EventBits_t;
+
+EventGroupHandle_t xEventGroupCreate();
+void vEventGroupDelete(EventGroupHandle_t group);
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group,
+                               const EventBits_t bitsToSet);
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group,
+                                 const EventBits_t bitsToClear);
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group);
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group,
+                                const EventBits_t bitsToWaitFor,
+                                const BaseType_t clearOnExit,
+                                const BaseType_t waitForAllBits,
+                                TickType_t ticksToWait);
+
+#endif
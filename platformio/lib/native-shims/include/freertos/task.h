@@ -0,0 +1,39 @@
+/* Host FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __FREERTOS_TASK_H__
+#define __FREERTOS_TASK_H__
+
+#include "freertos/FreeRTOS.h"
+
+typedef struct NativeTask *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+// Tasks run on their own thread. Priorities, stack sizes and core affinity are
+// ignored.
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskCode, const char *name,
+                                   uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *createdTask,
+                                   BaseType_t coreId);
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char *name,
+                       uint32_t stackDepth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *createdTask);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+
+#endif
@@ -0,0 +1,43 @@
+/* Host simulation settings for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __NATIVE_ENV_H__
+#define __NATIVE_ENV_H__
+
+#include <ctime>
+
+// The simulated hardware is configured through environment variables:
+//
+//   NATIVE_TIME         wall clock, seconds since the epoch (default: now)
+//   NATIVE_HTTP_FILE    file returned as the body of every HTTP GET
+//   NATIVE_HTTP_SERVER  host:port of a plain HTTP server to forward GETs to
+//   NATIVE_WIFI         ok, fail or nossid (default: ok)
+//   NATIVE_RSSI         WiFi signal strength in dBm (default: -60)
+//   NATIVE_BATTERY_MV   battery voltage in mV (default: 4100)
+//   NATIVE_BME          ok or absent (default: ok)
+//   NATIVE_BME_TEMP     indoor temperature in Celsius (default: 21.5)
+//   NATIVE_BME_HUMIDITY indoor humidity in % (default: 45)
+//   NATIVE_EPD_BUSY     1 to hold BUSY for the panel's refresh time (default: 0)
+//   NATIVE_WAKE         timer to report a timer wake instead of a fresh boot
+//   NATIVE_NVS          file that persists Preferences between runs
+//   NATIVE_FRAME        path prefix for the panel dump (default: frame)
+
+const char *nativeEnv(const char *name, const char *fallback);
+long nativeEnvInt(const char *name, long fallback);
+double nativeEnvFloat(const char *name, double fallback);
+time_t nativeTime();
+
+#endif
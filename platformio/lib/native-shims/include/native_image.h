@@ -0,0 +1,30 @@
+/* 1-bit image files for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef __NATIVE_IMAGE_H__
+#define __NATIVE_IMAGE_H__
+
+#include <cstdint>
+#include <vector>
+
+// Both take a frame packed 8 pixels per byte, MSB first, rows padded to a
+// whole byte, where a set bit is a white pixel (the GxEPD2 buffer layout).
+bool writePBM(const char *path, const uint8_t *bits, uint16_t w, uint16_t h);
+bool writePNG(const char *path, const uint8_t *bits, uint16_t w, uint16_t h);
+bool readPBM(const char *path, std::vector<uint8_t> &bits, uint16_t &w,
+             uint16_t &h);
+
+#endif
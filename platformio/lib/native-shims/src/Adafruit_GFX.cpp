@@ -0,0 +1,639 @@
+/* Host Adafruit GFX shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdlib>
+#include <utility>
+
+#include "Adafruit_GFX.h"
+#include "pgmspace.h"
+
+// width and height of a character cell in the built-in font
+#define CLASSIC_W 6
+#define CLASSIC_H 8
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h) {
+  _width = WIDTH;
+  _height = HEIGHT;
+  rotation = 0;
+  cursor_y = cursor_x = 0;
+  textsize_x = textsize_y = 1;
+  textcolor = textbgcolor = 0xFFFF;
+  wrap = true;
+  _cp437 = false;
+  gfxFont = nullptr;
+}
+
+/* Bresenham's algorithm, as in Adafruit GFX.
+ */
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                             uint16_t color) {
+  bool steep = abs(y1 - y0) > abs(x1 - x0);
+  if (steep) {
+    std::swap(x0, y0);
+    std::swap(x1, y1);
+  }
+  if (x0 > x1) {
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+  }
+
+  int16_t dx = x1 - x0;
+  int16_t dy = abs(y1 - y0);
+  int16_t err = dx / 2;
+  int16_t ystep = y0 < y1 ? 1 : -1;
+
+  for (; x0 <= x1; x0++) {
+    if (steep) {
+      writePixel(y0, x0, color);
+    } else {
+      writePixel(x0, y0, color);
+    }
+    err -= dy;
+    if (err < 0) {
+      y0 += ystep;
+      err += dx;
+    }
+  }
+}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+  rotation = r & 3;
+  switch (rotation) {
+  case 0:
+  case 2:
+    _width = WIDTH;
+    _height = HEIGHT;
+    break;
+  case 1:
+  case 3:
+    _width = HEIGHT;
+    _height = WIDTH;
+    break;
+  }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                 uint16_t color) {
+  startWrite();
+  writeLine(x, y, x, y + h - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                 uint16_t color) {
+  startWrite();
+  writeLine(x, y, x + w - 1, y, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  startWrite();
+  for (int16_t i = x; i < x + w; i++) {
+    writeFastVLine(i, y, h, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                            uint16_t color) {
+  if (x0 == x1) {
+    if (y0 > y1) {
+      std::swap(y0, y1);
+    }
+    drawFastVLine(x0, y0, y1 - y0 + 1, color);
+  } else if (y0 == y1) {
+    if (x0 > x1) {
+      std::swap(x0, x1);
+    }
+    drawFastHLine(x0, y0, x1 - x0 + 1, color);
+  } else {
+    startWrite();
+    writeLine(x0, y0, x1, y1, color);
+    endWrite();
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  startWrite();
+  writeFastHLine(x, y, w, color);
+  writeFastHLine(x, y + h - 1, w, color);
+  writeFastVLine(x, y, h, color);
+  writeFastVLine(x + w - 1, y, h, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  startWrite();
+  writePixel(x0, y0 + r, color);
+  writePixel(x0, y0 - r, color);
+  writePixel(x0 + r, y0, color);
+  writePixel(x0 - r, y0, color);
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    writePixel(x0 + x, y0 + y, color);
+    writePixel(x0 - x, y0 + y, color);
+    writePixel(x0 + x, y0 - y, color);
+    writePixel(x0 - x, y0 - y, color);
+    writePixel(x0 + y, y0 + x, color);
+    writePixel(x0 - y, y0 + x, color);
+    writePixel(x0 + y, y0 - x, color);
+    writePixel(x0 - y, y0 - x, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r,
+                                    uint8_t cornername, uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    if (cornername & 0x4) {
+      writePixel(x0 + x, y0 + y, color);
+      writePixel(x0 + y, y0 + x, color);
+    }
+    if (cornername & 0x2) {
+      writePixel(x0 + x, y0 - y, color);
+      writePixel(x0 + y, y0 - x, color);
+    }
+    if (cornername & 0x8) {
+      writePixel(x0 - y, y0 + x, color);
+      writePixel(x0 - x, y0 + y, color);
+    }
+    if (cornername & 0x1) {
+      writePixel(x0 - y, y0 - x, color);
+      writePixel(x0 - x, y0 - y, color);
+    }
+  }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r,
+                              uint16_t color) {
+  startWrite();
+  writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+  fillCircleHelper(x0, y0, r, 3, 0, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r,
+                                    uint8_t corners, int16_t delta,
+                                    uint16_t color) {
+  int16_t f = 1 - r;
+  int16_t ddF_x = 1;
+  int16_t ddF_y = -2 * r;
+  int16_t x = 0;
+  int16_t y = r;
+  int16_t px = x;
+  int16_t py = y;
+
+  delta++; // avoid some +1's in the loop
+
+  while (x < y) {
+    if (f >= 0) {
+      y--;
+      ddF_y += 2;
+      f += ddF_y;
+    }
+    x++;
+    ddF_x += 2;
+    f += ddF_x;
+    // these checks avoid double-drawing certain lines
+    if (x < (y + 1)) {
+      if (corners & 1) {
+        writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+      }
+      if (corners & 2) {
+        writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+      }
+    }
+    if (y != py) {
+      if (corners & 1) {
+        writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+      }
+      if (corners & 2) {
+        writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+      }
+      py = y;
+    }
+    px = x;
+  }
+}
+
+void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0, int16_t x1,
+                                int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+  drawLine(x0, y0, x1, y1, color);
+  drawLine(x1, y1, x2, y2, color);
+  drawLine(x2, y2, x0, y0, color);
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1,
+                                int16_t y1, int16_t x2, int16_t y2,
+                                uint16_t color) {
+  int16_t a, b, y, last;
+
+  // sort coordinates by Y order (y2 >= y1 >= y0)
+  if (y0 > y1) {
+    std::swap(y0, y1);
+    std::swap(x0, x1);
+  }
+  if (y1 > y2) {
+    std::swap(y2, y1);
+    std::swap(x2, x1);
+  }
+  if (y0 > y1) {
+    std::swap(y0, y1);
+    std::swap(x0, x1);
+  }
+
+  startWrite();
+  if (y0 == y2) { // all on the same line
+    a = b = x0;
+    if (x1 < a) {
+      a = x1;
+    } else if (x1 > b) {
+      b = x1;
+    }
+    if (x2 < a) {
+      a = x2;
+    } else if (x2 > b) {
+      b = x2;
+    }
+    writeFastHLine(a, y0, b - a + 1, color);
+    endWrite();
+    return;
+  }
+
+  int16_t dx01 = x1 - x0;
+  int16_t dy01 = y1 - y0;
+  int16_t dx02 = x2 - x0;
+  int16_t dy02 = y2 - y0;
+  int16_t dx12 = x2 - x1;
+  int16_t dy12 = y2 - y1;
+  int32_t sa = 0;
+  int32_t sb = 0;
+
+  // upper part, scanline y1 is included here only if the lower part is flat
+  last = y1 == y2 ? y1 : y1 - 1;
+  for (y = y0; y <= last; y++) {
+    a = x0 + sa / dy01;
+    b = x0 + sb / dy02;
+    sa += dx01;
+    sb += dx02;
+    if (a > b) {
+      std::swap(a, b);
+    }
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+
+  // lower part
+  sa = static_cast<int32_t>(dx12) * (y - y1);
+  sb = static_cast<int32_t>(dx02) * (y - y0);
+  for (; y <= y2; y++) {
+    a = x1 + sa / dy12;
+    b = x0 + sb / dy02;
+    sa += dx12;
+    sb += dx02;
+    if (a > b) {
+      std::swap(a, b);
+    }
+    writeFastHLine(a, y, b - a + 1, color);
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 int16_t r, uint16_t color) {
+  int16_t max_radius = (w < h ? w : h) / 2;
+  if (r > max_radius) {
+    r = max_radius;
+  }
+  startWrite();
+  writeFastHLine(x + r, y, w - 2 * r, color);
+  writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+  writeFastVLine(x, y + r, h - 2 * r, color);
+  writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+  drawCircleHelper(x + r, y + r, r, 1, color);
+  drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+  drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+  drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+  endWrite();
+}
+
+void Adafruit_GFX::fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                                 int16_t r, uint16_t color) {
+  int16_t max_radius = (w < h ? w : h) / 2;
+  if (r > max_radius) {
+    r = max_radius;
+  }
+  startWrite();
+  writeFillRect(x + r, y, w - 2 * r, h, color);
+  fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, color);
+  fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, color);
+  endWrite();
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                              int16_t w, int16_t h, uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8; // bitmap scanline pad = whole byte
+  uint8_t b = 0;
+
+  startWrite();
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7) {
+        b <<= 1;
+      } else {
+        b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      }
+      if (b & 0x80) {
+        writePixel(x + i, y, color);
+      }
+    }
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                              int16_t w, int16_t h, uint16_t color,
+                              uint16_t bg) {
+  int16_t byteWidth = (w + 7) / 8;
+  uint8_t b = 0;
+
+  startWrite();
+  for (int16_t j = 0; j < h; j++, y++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (i & 7) {
+        b <<= 1;
+      } else {
+        b = pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+      }
+      writePixel(x + i, y, (b & 0x80) ? color : bg);
+    }
+  }
+  endWrite();
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size) {
+  drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size_x,
+                            uint8_t size_y) {
+  if (!gfxFont) {
+    return; // no built-in font
+  }
+
+  c -= static_cast<uint8_t>(pgm_read_byte(&gfxFont->first));
+  const GFXglyph *glyph = &gfxFont->glyph[c];
+  const uint8_t *bitmap = gfxFont->bitmap;
+
+  uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
+  uint8_t w = pgm_read_byte(&glyph->width);
+  uint8_t h = pgm_read_byte(&glyph->height);
+  int8_t xo = pgm_read_byte(&glyph->xOffset);
+  int8_t yo = pgm_read_byte(&glyph->yOffset);
+  uint8_t bits = 0;
+  uint8_t bit = 0;
+  int16_t xo16 = 0;
+  int16_t yo16 = 0;
+
+  if (size_x > 1 || size_y > 1) {
+    xo16 = xo;
+    yo16 = yo;
+  }
+
+  // glyph bitmaps are packed bits with no row padding, and the background
+  // color is not supported, as in Adafruit GFX
+  startWrite();
+  for (uint8_t yy = 0; yy < h; yy++) {
+    for (uint8_t xx = 0; xx < w; xx++) {
+      if (!(bit++ & 7)) {
+        bits = pgm_read_byte(&bitmap[bo++]);
+      }
+      if (bits & 0x80) {
+        if (size_x == 1 && size_y == 1) {
+          writePixel(x + xo + xx, y + yo + yy, color);
+        } else {
+          writeFillRect(x + (xo16 + xx) * size_x, y + (yo16 + yy) * size_y,
+                        size_x, size_y, color);
+        }
+      }
+      bits <<= 1;
+    }
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * CLASSIC_H;
+    } else if (c != '\r') {
+      if (wrap && ((cursor_x + textsize_x * CLASSIC_W) > _width)) {
+        cursor_x = 0;
+        cursor_y += textsize_y * CLASSIC_H;
+      }
+      cursor_x += textsize_x * CLASSIC_W;
+    }
+    return 1;
+  }
+
+  uint8_t yAdvance = pgm_read_byte(&gfxFont->yAdvance);
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += static_cast<int16_t>(textsize_y) * yAdvance;
+  } else if (c != '\r') {
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    if (c >= first && c <= static_cast<uint8_t>(pgm_read_byte(&gfxFont->last))) {
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t w = pgm_read_byte(&glyph->width);
+      uint8_t h = pgm_read_byte(&glyph->height);
+      if (w > 0 && h > 0) {
+        int16_t xo = static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+        if (wrap && ((cursor_x + textsize_x * (xo + w)) > _width)) {
+          cursor_x = 0;
+          cursor_y += static_cast<int16_t>(textsize_y) * yAdvance;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+                 textsize_y);
+      }
+      cursor_x +=
+          pgm_read_byte(&glyph->xAdvance) * static_cast<int16_t>(textsize_x);
+    }
+  }
+  return 1;
+}
+
+void Adafruit_GFX::setTextSize(uint8_t sx, uint8_t sy) {
+  textsize_x = sx > 0 ? sx : 1;
+  textsize_y = sy > 0 ? sy : 1;
+}
+
+void Adafruit_GFX::setFont(const GFXfont *f) {
+  if (f) {
+    if (!gfxFont) {
+      // switching from classic to new font behavior, move cursor pos down
+      cursor_y += 6;
+    }
+  } else if (gfxFont) {
+    // switching from new to classic font behavior, move cursor pos up
+    cursor_y -= 6;
+  }
+  gfxFont = const_cast<GFXfont *>(f);
+}
+
+void Adafruit_GFX::charBounds(unsigned char c, int16_t *x, int16_t *y,
+                              int16_t *minx, int16_t *miny, int16_t *maxx,
+                              int16_t *maxy) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      *x = 0;
+      *y += textsize_y * CLASSIC_H;
+    } else if (c != '\r') {
+      if (wrap && ((*x + textsize_x * CLASSIC_W) > _width)) {
+        *x = 0;
+        *y += textsize_y * CLASSIC_H;
+      }
+      int x2 = *x + textsize_x * CLASSIC_W - 1;
+      int y2 = *y + textsize_y * CLASSIC_H - 1;
+      if (x2 > *maxx) {
+        *maxx = x2;
+      }
+      if (y2 > *maxy) {
+        *maxy = y2;
+      }
+      if (*x < *minx) {
+        *minx = *x;
+      }
+      if (*y < *miny) {
+        *miny = *y;
+      }
+      *x += textsize_x * CLASSIC_W;
+    }
+    return;
+  }
+
+  if (c == '\n') {
+    *x = 0;
+    *y += textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+  } else if (c != '\r') {
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    uint8_t last = pgm_read_byte(&gfxFont->last);
+    if (c >= first && c <= last) {
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t gw = pgm_read_byte(&glyph->width);
+      uint8_t gh = pgm_read_byte(&glyph->height);
+      uint8_t xa = pgm_read_byte(&glyph->xAdvance);
+      int8_t xo = pgm_read_byte(&glyph->xOffset);
+      int8_t yo = pgm_read_byte(&glyph->yOffset);
+      if (wrap && ((*x + ((static_cast<int16_t>(xo) + gw) * textsize_x))
+                   > _width)) {
+        *x = 0;
+        *y += textsize_y * pgm_read_byte(&gfxFont->yAdvance);
+      }
+      int16_t tsx = textsize_x;
+      int16_t tsy = textsize_y;
+      int16_t x1 = *x + xo * tsx;
+      int16_t y1 = *y + yo * tsy;
+      int16_t x2 = x1 + gw * tsx - 1;
+      int16_t y2 = y1 + gh * tsy - 1;
+      if (x1 < *minx) {
+        *minx = x1;
+      }
+      if (y1 < *miny) {
+        *miny = y1;
+      }
+      if (x2 > *maxx) {
+        *maxx = x2;
+      }
+      if (y2 > *maxy) {
+        *maxy = y2;
+      }
+      *x += xa * tsx;
+    }
+  }
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  uint8_t c;
+  int16_t minx = 0x7FFF;
+  int16_t miny = 0x7FFF;
+  int16_t maxx = -1;
+  int16_t maxy = -1;
+
+  *x1 = x;
+  *y1 = y;
+  *w = *h = 0;
+
+  while ((c = *str++)) {
+    charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+  }
+
+  if (maxx >= minx) {
+    *x1 = minx;
+    *w = maxx - minx + 1;
+  }
+  if (maxy >= miny) {
+    *y1 = miny;
+    *h = maxy - miny + 1;
+  }
+}
+
+/* Unlike Adafruit GFX, an empty string sets the outputs the same way the
+ * const char * version does, instead of leaving them untouched.
+ */
+void Adafruit_GFX::getTextBounds(const String &str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+}
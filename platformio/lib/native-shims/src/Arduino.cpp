@@ -0,0 +1,237 @@
+/* Host Arduino core shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <time.h>
+
+#include "Arduino.h"
+#include "driver/gpio.h"
+#include "esp_sntp.h"
+#include "native_env.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+
+static const auto bootTime = std::chrono::steady_clock::now();
+static uint32_t cpuFreqMhz = 80;
+
+// simulated GPIO state
+static uint8_t pinLevel[GPIO_NUM_MAX];
+static void (*pinHandler[GPIO_NUM_MAX])(void);
+static int pinHandlerMode[GPIO_NUM_MAX];
+
+static sntp_sync_status_t sntpStatus = SNTP_SYNC_STATUS_RESET;
+
+const char *nativeEnv(const char *name, const char *fallback) {
+  const char *v = getenv(name);
+  return v && *v ? v : fallback;
+}
+
+long nativeEnvInt(const char *name, long fallback) {
+  const char *v = getenv(name);
+  return v && *v ? strtol(v, nullptr, 0) : fallback;
+}
+
+double nativeEnvFloat(const char *name, double fallback) {
+  const char *v = getenv(name);
+  return v && *v ? strtod(v, nullptr) : fallback;
+}
+
+/* Returns the simulated wall clock. NATIVE_TIME pins it, so that renders are
+ * reproducible.
+ */
+time_t nativeTime() {
+  static const time_t fixed = nativeEnvInt("NATIVE_TIME", 0);
+  return fixed ? fixed : time(nullptr);
+}
+
+unsigned long millis() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - bootTime)
+      .count();
+}
+
+unsigned long micros() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - bootTime)
+      .count();
+}
+
+void delay(uint32_t ms) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us) {
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield() { std::this_thread::yield(); }
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+/* Sets the simulated pin level and runs its interrupt handler, if attached and
+ * the edge matches.
+ */
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin >= GPIO_NUM_MAX) {
+    return;
+  }
+  uint8_t old = pinLevel[pin];
+  pinLevel[pin] = val ? HIGH : LOW;
+  void (*handler)(void) = pinHandler[pin];
+  if (handler == nullptr || old == pinLevel[pin]) {
+    return;
+  }
+  int mode = pinHandlerMode[pin];
+  if (mode == CHANGE || (mode == RISING && val) || (mode == FALLING && !val)) {
+    handler();
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  return pin < GPIO_NUM_MAX ? pinLevel[pin] : LOW;
+}
+
+/* The only analog input is the battery voltage divider (1M+1M), so this
+ * returns half of NATIVE_BATTERY_MV, in mV.
+ */
+uint16_t analogRead(uint8_t pin) {
+  return nativeEnvInt("NATIVE_BATTERY_MV", 4100) / 2;
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode) {
+  if (pin < GPIO_NUM_MAX) {
+    pinHandler[pin] = handler;
+    pinHandlerMode[pin] = mode;
+  }
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < GPIO_NUM_MAX) {
+    pinHandler[pin] = nullptr;
+  }
+}
+
+int gpio_get_level(gpio_num_t gpio_num) { return digitalRead(gpio_num); }
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+  digitalWrite(gpio_num, level);
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_enable(gpio_num_t gpio_num, gpio_int_type_t intr_type) {
+  return ESP_OK;
+}
+esp_err_t gpio_wakeup_disable(gpio_num_t gpio_num) { return ESP_OK; }
+esp_err_t gpio_hold_en(gpio_num_t gpio_num) { return ESP_OK; }
+esp_err_t gpio_hold_dis(gpio_num_t gpio_num) { return ESP_OK; }
+void gpio_deep_sleep_hold_en() {}
+void gpio_deep_sleep_hold_dis() {}
+
+bool setCpuFrequencyMhz(uint32_t cpu_freq_mhz) {
+  cpuFreqMhz = cpu_freq_mhz;
+  return true;
+}
+
+uint32_t getCpuFrequencyMhz() { return cpuFreqMhz; }
+
+void configTime(long gmtOffset_sec, int daylightOffset_sec,
+                const char *server1, const char *server2,
+                const char *server3) {
+  sntpStatus = SNTP_SYNC_STATUS_COMPLETED;
+}
+
+void configTzTime(const char *tz, const char *server1, const char *server2,
+                  const char *server3) {
+  setenv("TZ", tz, 1);
+  tzset();
+  sntpStatus = SNTP_SYNC_STATUS_COMPLETED;
+}
+
+/* Same as the Arduino-ESP32 core, but reads the simulated wall clock. It never
+ * has to wait for a time sync, so ms is unused.
+ */
+bool getLocalTime(struct tm *info, uint32_t ms) {
+  time_t now = nativeTime();
+  localtime_r(&now, info);
+  return info->tm_year > (2016 - 1900);
+}
+
+sntp_sync_status_t sntp_get_sync_status() { return sntpStatus; }
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {}
+
+long random(long howbig) { return howbig ? rand() % howbig : 0; }
+
+long random(long howsmall, long howbig) {
+  return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+void randomSeed(unsigned long seed) { srand(seed); }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+void EspClass::restart() {
+  fflush(stdout);
+  exit(0);
+}
+
+const char *esp_err_to_name(esp_err_t code) {
+  switch (code) {
+  case ESP_OK:
+    return "ESP_OK";
+  case ESP_FAIL:
+    return "ESP_FAIL";
+  case ESP_ERR_NO_MEM:
+    return "ESP_ERR_NO_MEM";
+  case ESP_ERR_INVALID_ARG:
+    return "ESP_ERR_INVALID_ARG";
+  case ESP_ERR_INVALID_STATE:
+    return "ESP_ERR_INVALID_STATE";
+  case ESP_ERR_NOT_FOUND:
+    return "ESP_ERR_NOT_FOUND";
+  case ESP_ERR_NOT_SUPPORTED:
+    return "ESP_ERR_NOT_SUPPORTED";
+  case ESP_ERR_TIMEOUT:
+    return "ESP_ERR_TIMEOUT";
+  default:
+    return "UNKNOWN ERROR";
+  }
+}
+
+/* Serial output goes to stdout. Carriage returns are dropped, they only make a
+ * mess of terminals and log files.
+ */
+size_t HardwareSerial::write(uint8_t c) {
+  if (c != '\r') {
+    fputc(c, stdout);
+  }
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    write(buffer[i]);
+  }
+  return size;
+}
+
+void HardwareSerial::flush() { fflush(stdout); }
@@ -0,0 +1,318 @@
+/* Host GxEPD2 shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+#include <string>
+
+#include "GxEPD2_EPD.h"
+#include "native_env.h"
+#include "native_image.h"
+
+/* Every panel constructed, so that they can be saved at deep sleep. Panels are
+ * usually globals, so this must not depend on static initialization order.
+ * Host tools may create panels on several threads, registryMutex guards it.
+ */
+static std::vector<const GxEPD2_EPD *> &registry() {
+  static std::vector<const GxEPD2_EPD *> panels;
+  return panels;
+}
+static std::mutex registryMutex;
+
+GxEPD2_EPD::GxEPD2_EPD(int16_t cs, int16_t dc, int16_t rst, int16_t busy,
+                       int16_t busy_level, uint32_t busy_timeout, uint16_t w,
+                       uint16_t h, bool partial, bool fast_partial,
+                       uint16_t full_refresh_time,
+                       uint16_t partial_refresh_time)
+    : WIDTH(w), HEIGHT(h), hasPartialUpdate(partial),
+      hasFastPartialUpdate(fast_partial), _busy(busy),
+      _busy_level(busy_level), _busy_timeout(busy_timeout),
+      _full_refresh_time(full_refresh_time),
+      _partial_refresh_time(partial_refresh_time), _power_is_on(false),
+      _hibernating(false), _initial_write(true), _initial_refresh(true),
+      _command(0), _cascade(0), _forced_temperature(0),
+      _busy_callback(nullptr),
+      _busy_callback_parameter(nullptr), _full_refreshes(0),
+      _partial_refreshes(0), _fast_refreshes(0) {
+  size_t bytes = (w + 7) / 8 * h;
+  _ram.assign(bytes, 0xFF);
+  _previous.assign(bytes, 0xFF);
+  _panel.assign(bytes, 0xFF);
+  std::lock_guard<std::mutex> lock(registryMutex);
+  registry().push_back(this);
+}
+
+// GxEPD2_BW copies the panel it is given, so copies must register too
+GxEPD2_EPD::GxEPD2_EPD(const GxEPD2_EPD &other)
+    : WIDTH(other.WIDTH), HEIGHT(other.HEIGHT),
+      hasPartialUpdate(other.hasPartialUpdate),
+      hasFastPartialUpdate(other.hasFastPartialUpdate), _busy(other._busy),
+      _busy_level(other._busy_level), _busy_timeout(other._busy_timeout),
+      _full_refresh_time(other._full_refresh_time),
+      _partial_refresh_time(other._partial_refresh_time),
+      _power_is_on(other._power_is_on), _hibernating(other._hibernating),
+      _initial_write(other._initial_write),
+      _initial_refresh(other._initial_refresh), _command(other._command),
+      _cascade(other._cascade),
+      _forced_temperature(other._forced_temperature),
+      _busy_callback(other._busy_callback),
+      _busy_callback_parameter(other._busy_callback_parameter),
+      _ram(other._ram), _previous(other._previous), _panel(other._panel),
+      _full_refreshes(other._full_refreshes),
+      _partial_refreshes(other._partial_refreshes),
+      _fast_refreshes(other._fast_refreshes) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  registry().push_back(this);
+}
+
+GxEPD2_EPD::~GxEPD2_EPD() {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  std::vector<const GxEPD2_EPD *> &panels = registry();
+  panels.erase(std::remove(panels.begin(), panels.end(), this), panels.end());
+}
+
+void GxEPD2_EPD::init(uint32_t serial_diag_bitrate) {
+  init(serial_diag_bitrate, true, 10, false);
+}
+
+void GxEPD2_EPD::init(uint32_t serial_diag_bitrate, bool initial,
+                      uint16_t reset_duration, bool pulldown_rst_mode) {
+  // the panel is not busy
+  if (_busy >= 0) {
+    digitalWrite(_busy, !_busy_level);
+  }
+  if (_hibernating) {
+    std::fill(_ram.begin(), _ram.end(), 0xFF);
+    std::fill(_previous.begin(), _previous.end(), 0xFF);
+    _cascade = 0;
+    _forced_temperature = 0;
+  }
+  _hibernating = false;
+  _initial_write = initial;
+  _initial_refresh = initial;
+}
+
+void GxEPD2_EPD::setBusyCallback(void (*busyCallback)(const void *),
+                                 const void *busy_callback_parameter) {
+  _busy_callback = busyCallback;
+  _busy_callback_parameter = busy_callback_parameter;
+}
+
+void GxEPD2_EPD::clearScreen(uint8_t value) {
+  writeScreenBuffer(value);
+  refresh(true);
+  std::fill(_previous.begin(), _previous.end(), value);
+}
+
+void GxEPD2_EPD::writeScreenBuffer(uint8_t value) {
+  std::fill(_ram.begin(), _ram.end(), value);
+}
+
+void GxEPD2_EPD::writeImage(const uint8_t bitmap[], int16_t x, int16_t y,
+                            int16_t w, int16_t h, bool invert, bool mirror_y,
+                            bool pgm) {
+  _writeRam(_ram, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_EPD::writeImageForFullRefresh(const uint8_t bitmap[], int16_t x,
+                                          int16_t y, int16_t w, int16_t h,
+                                          bool invert, bool mirror_y,
+                                          bool pgm) {
+  _writeRam(_previous, bitmap, x, y, w, h, invert, mirror_y);
+  _writeRam(_ram, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_EPD::writeImageAgain(const uint8_t bitmap[], int16_t x, int16_t y,
+                                 int16_t w, int16_t h, bool invert,
+                                 bool mirror_y, bool pgm) {
+  _writeRam(_previous, bitmap, x, y, w, h, invert, mirror_y);
+  _writeRam(_ram, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_EPD::writeImagePrevious(const uint8_t bitmap[], int16_t x,
+                                    int16_t y, int16_t w, int16_t h,
+                                    bool invert, bool mirror_y, bool pgm) {
+  _writeRam(_previous, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_EPD::writeImageNew(const uint8_t bitmap[], int16_t x, int16_t y,
+                               int16_t w, int16_t h, bool invert,
+                               bool mirror_y, bool pgm) {
+  _writeRam(_ram, bitmap, x, y, w, h, invert, mirror_y);
+}
+
+void GxEPD2_EPD::refresh(bool partial_update_mode) {
+  if (partial_update_mode) {
+    refresh(0, 0, WIDTH, HEIGHT);
+    return;
+  }
+  _power_is_on = true;
+  _showRam(0, 0, WIDTH, HEIGHT, false);
+  _initial_refresh = false;
+  ++_full_refreshes;
+  if ((_cascade & 0x02) && _forced_temperature >= 40
+      && _forced_temperature < 0x80) {
+    ++_fast_refreshes;
+    _waitWhileBusy("refresh", _full_refresh_time * 2 / 5);
+  } else {
+    _waitWhileBusy("refresh", _full_refresh_time);
+  }
+}
+
+void GxEPD2_EPD::refresh(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (_initial_refresh) {
+    refresh(false); // initial update needs to be a full update
+    return;
+  }
+  // same clipping and byte alignment as the controller's partial window
+  int16_t x1 = x < 0 ? 0 : x;
+  int16_t y1 = y < 0 ? 0 : y;
+  int16_t x2 = std::min<int16_t>(x + w, WIDTH);
+  int16_t y2 = std::min<int16_t>(y + h, HEIGHT);
+  if (x1 >= x2 || y1 >= y2) {
+    return;
+  }
+  x1 -= x1 % 8;
+  _power_is_on = true;
+  _showRam(x1, y1, x2 - x1, y2 - y1, true);
+  ++_partial_refreshes;
+  _waitWhileBusy("refresh", _partial_refresh_time);
+}
+
+void GxEPD2_EPD::powerOff() { _power_is_on = false; }
+
+void GxEPD2_EPD::hibernate() {
+  powerOff();
+  _hibernating = true;
+}
+
+/* Copies a region of a bitmap into controller RAM. x and w are rounded to
+ * whole bytes like on the controller.
+ */
+void GxEPD2_EPD::_writeRam(std::vector<uint8_t> &ram, const uint8_t bitmap[],
+                           int16_t x, int16_t y, int16_t w, int16_t h,
+                           bool invert, bool mirror_y) {
+  if (_initial_write) {
+    // initial full screen buffer clean, both images
+    std::fill(_ram.begin(), _ram.end(), 0xFF);
+    std::fill(_previous.begin(), _previous.end(), 0xFF);
+    _initial_write = false;
+  }
+  int16_t wb = (w + 7) / 8;
+  x -= x % 8;
+  int16_t ramWb = (WIDTH + 7) / 8;
+  for (int16_t i = 0; i < h; ++i) {
+    int16_t yy = y + i;
+    if (yy < 0 || yy >= HEIGHT) {
+      continue;
+    }
+    int16_t row = mirror_y ? h - 1 - i : i;
+    for (int16_t j = 0; j < wb; ++j) {
+      int16_t xx = x / 8 + j;
+      if (xx < 0 || xx >= ramWb) {
+        continue;
+      }
+      uint8_t data = bitmap[row * wb + j];
+      ram[yy * ramWb + xx] = invert ? ~data : data;
+    }
+  }
+}
+
+/* Moves a region of controller RAM onto the panel. A partial refresh only
+ * changes the pixels where the previous and the new image differ.
+ */
+void GxEPD2_EPD::_showRam(int16_t x, int16_t y, int16_t w, int16_t h,
+                          bool partial) {
+  int16_t ramWb = (WIDTH + 7) / 8;
+  int16_t xb = x / 8;
+  int16_t wb = std::min<int16_t>((w + 7) / 8, ramWb - xb);
+  for (int16_t yy = y; yy < y + h; ++yy) {
+    for (size_t i = yy * ramWb + xb; i < yy * ramWb + xb + wb; ++i) {
+      uint8_t driven = partial ? _ram[i] ^ _previous[i] : 0xFF;
+      _panel[i] = (_panel[i] & ~driven) | (_ram[i] & driven);
+      _previous[i] = _ram[i];
+    }
+  }
+}
+
+/* Only the commands that select the refresh waveform are simulated.
+ */
+void GxEPD2_EPD::_writeCommand(uint8_t c) { _command = c; }
+
+void GxEPD2_EPD::_writeData(uint8_t d) {
+  if (_command == 0xE0) {
+    _cascade = d;
+  } else if (_command == 0xE5) {
+    _forced_temperature = d;
+  }
+}
+
+/* Holds BUSY active for busy_time ms (NATIVE_EPD_BUSY=1) or not at all, calling
+ * the busy callback while waiting, as GxEPD2 does. Releasing BUSY runs its
+ * interrupt handler, if one is attached.
+ */
+void GxEPD2_EPD::_waitWhileBusy(const char *comment, uint16_t busy_time) {
+  if (_busy < 0) {
+    return;
+  }
+  static const bool simulate = nativeEnvInt("NATIVE_EPD_BUSY", 0) != 0;
+  unsigned long start = millis();
+  digitalWrite(_busy, _busy_level);
+  while (digitalRead(_busy) == _busy_level) {
+    unsigned long elapsed = millis() - start;
+    if (!simulate || elapsed >= busy_time) {
+      digitalWrite(_busy, !_busy_level);
+      break;
+    }
+    if (elapsed * 1000 > _busy_timeout) {
+      Serial.printf("Busy Timeout! %s\n", comment);
+      break;
+    }
+    if (_busy_callback) {
+      _busy_callback(_busy_callback_parameter);
+    } else {
+      delay(1);
+    }
+  }
+}
+
+/* Writes <prefix>.pbm and <prefix>.png with what the panel shows.
+ */
+bool GxEPD2_EPD::savePanel(const char *prefix) const {
+  std::string path(prefix);
+  return writePBM((path + ".pbm").c_str(), _panel.data(), WIDTH, HEIGHT)
+         && writePNG((path + ".png").c_str(), _panel.data(), WIDTH, HEIGHT);
+}
+
+/* Saves every panel. With more than one, each prefix gets a suffix.
+ */
+bool GxEPD2_EPD::saveAll(const char *prefix) {
+  std::lock_guard<std::mutex> lock(registryMutex);
+  const std::vector<const GxEPD2_EPD *> &panels = registry();
+  bool ok = true;
+  for (size_t i = 0; i < panels.size(); ++i) {
+    std::string p(prefix);
+    if (panels.size() > 1) {
+      p += "_" + std::to_string(i);
+    }
+    if (!panels[i]->savePanel(p.c_str())) {
+      fprintf(stderr, "failed to write %s\n", p.c_str());
+      ok = false;
+    }
+  }
+  return ok;
+}
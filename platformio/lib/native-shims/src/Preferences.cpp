@@ -0,0 +1,252 @@
+/* Host Preferences shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Preferences.h"
+#include "native_env.h"
+
+// all namespaces, keyed by "namespace/key"
+static std::map<std::string, std::vector<uint8_t>> &store() {
+  static std::map<std::string, std::vector<uint8_t>> s;
+  return s;
+}
+
+/* Loads NATIVE_NVS the first time any namespace is opened. The file is a
+ * sequence of entries, each a 16-bit key length, key, 32-bit value length and
+ * value, in host byte order.
+ */
+static void load() {
+  static bool loaded = false;
+  const char *path = nativeEnv("NATIVE_NVS", nullptr);
+  if (loaded || path == nullptr) {
+    return;
+  }
+  loaded = true;
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr) {
+    return;
+  }
+  uint16_t keyLen;
+  while (fread(&keyLen, sizeof(keyLen), 1, f) == 1) {
+    std::string key(keyLen, '\0');
+    uint32_t len;
+    if (fread(&key[0], 1, keyLen, f) != keyLen
+        || fread(&len, sizeof(len), 1, f) != 1) {
+      break;
+    }
+    std::vector<uint8_t> value(len);
+    if (fread(value.data(), 1, len, f) != len) {
+      break;
+    }
+    store()[key] = value;
+  }
+  fclose(f);
+}
+
+static void save() {
+  const char *path = nativeEnv("NATIVE_NVS", nullptr);
+  if (path == nullptr) {
+    return;
+  }
+  FILE *f = fopen(path, "wb");
+  if (f == nullptr) {
+    return;
+  }
+  for (const auto &entry : store()) {
+    uint16_t keyLen = entry.first.size();
+    uint32_t len = entry.second.size();
+    fwrite(&keyLen, sizeof(keyLen), 1, f);
+    fwrite(entry.first.data(), 1, keyLen, f);
+    fwrite(&len, sizeof(len), 1, f);
+    fwrite(entry.second.data(), 1, len, f);
+  }
+  fclose(f);
+}
+
+std::string Preferences::fullKey(const char *key) const {
+  return _namespace + "/" + key;
+}
+
+bool Preferences::begin(const char *name, bool readOnly,
+                        const char *partition_label) {
+  if (_started || name == nullptr || strlen(name) > 15) {
+    return false;
+  }
+  load();
+  _namespace = name;
+  _readOnly = readOnly;
+  _started = true;
+  return true;
+}
+
+void Preferences::end() { _started = false; }
+
+bool Preferences::clear() {
+  if (!_started || _readOnly) {
+    return false;
+  }
+  std::string prefix = _namespace + "/";
+  auto &s = store();
+  for (auto it = s.begin(); it != s.end();) {
+    it = it->first.compare(0, prefix.size(), prefix) == 0 ? s.erase(it)
+                                                          : std::next(it);
+  }
+  save();
+  return true;
+}
+
+bool Preferences::remove(const char *key) {
+  if (!_started || _readOnly || !store().erase(fullKey(key))) {
+    return false;
+  }
+  save();
+  return true;
+}
+
+bool Preferences::isKey(const char *key) {
+  return _started && store().count(fullKey(key)) > 0;
+}
+
+size_t Preferences::putBytes(const char *key, const void *value, size_t len) {
+  if (!_started || _readOnly || key == nullptr || strlen(key) > 15) {
+    return 0;
+  }
+  const uint8_t *p = static_cast<const uint8_t *>(value);
+  store()[fullKey(key)] = std::vector<uint8_t>(p, p + len);
+  save();
+  return len;
+}
+
+size_t Preferences::getBytesLength(const char *key) {
+  if (!_started) {
+    return 0;
+  }
+  auto it = store().find(fullKey(key));
+  return it == store().end() ? 0 : it->second.size();
+}
+
+size_t Preferences::getBytes(const char *key, void *buf, size_t maxLen) {
+  size_t len = getBytesLength(key);
+  if (len == 0 || len > maxLen) {
+    return 0;
+  }
+  memcpy(buf, store()[fullKey(key)].data(), len);
+  return len;
+}
+
+size_t Preferences::putChar(const char *key, int8_t value) {
+  return put(key, value);
+}
+size_t Preferences::putUChar(const char *key, uint8_t value) {
+  return put(key, value);
+}
+size_t Preferences::putShort(const char *key, int16_t value) {
+  return put(key, value);
+}
+size_t Preferences::putUShort(const char *key, uint16_t value) {
+  return put(key, value);
+}
+size_t Preferences::putInt(const char *key, int32_t value) {
+  return put(key, value);
+}
+size_t Preferences::putUInt(const char *key, uint32_t value) {
+  return put(key, value);
+}
+size_t Preferences::putLong(const char *key, int32_t value) {
+  return put(key, value);
+}
+size_t Preferences::putULong(const char *key, uint32_t value) {
+  return put(key, value);
+}
+size_t Preferences::putLong64(const char *key, int64_t value) {
+  return put(key, value);
+}
+size_t Preferences::putULong64(const char *key, uint64_t value) {
+  return put(key, value);
+}
+size_t Preferences::putFloat(const char *key, float value) {
+  return put(key, value);
+}
+size_t Preferences::putDouble(const char *key, double value) {
+  return put(key, value);
+}
+size_t Preferences::putBool(const char *key, bool value) {
+  return put(key, static_cast<uint8_t>(value));
+}
+size_t Preferences::putString(const char *key, const char *value) {
+  return putBytes(key, value, strlen(value) + 1);
+}
+size_t Preferences::putString(const char *key, const String &value) {
+  return putString(key, value.c_str());
+}
+
+int8_t Preferences::getChar(const char *key, int8_t defaultValue) {
+  return get(key, defaultValue);
+}
+uint8_t Preferences::getUChar(const char *key, uint8_t defaultValue) {
+  return get(key, defaultValue);
+}
+int16_t Preferences::getShort(const char *key, int16_t defaultValue) {
+  return get(key, defaultValue);
+}
+uint16_t Preferences::getUShort(const char *key, uint16_t defaultValue) {
+  return get(key, defaultValue);
+}
+int32_t Preferences::getInt(const char *key, int32_t defaultValue) {
+  return get(key, defaultValue);
+}
+uint32_t Preferences::getUInt(const char *key, uint32_t defaultValue) {
+  return get(key, defaultValue);
+}
+int32_t Preferences::getLong(const char *key, int32_t defaultValue) {
+  return get(key, defaultValue);
+}
+uint32_t Preferences::getULong(const char *key, uint32_t defaultValue) {
+  return get(key, defaultValue);
+}
+int64_t Preferences::getLong64(const char *key, int64_t defaultValue) {
+  return get(key, defaultValue);
+}
+uint64_t Preferences::getULong64(const char *key, uint64_t defaultValue) {
+  return get(key, defaultValue);
+}
+float Preferences::getFloat(const char *key, float defaultValue) {
+  return get(key, defaultValue);
+}
+double Preferences::getDouble(const char *key, double defaultValue) {
+  return get(key, defaultValue);
+}
+bool Preferences::getBool(const char *key, bool defaultValue) {
+  return get(key, static_cast<uint8_t>(defaultValue)) != 0;
+}
+
+size_t Preferences::getString(const char *key, char *value, size_t maxLen) {
+  return getBytes(key, value, maxLen);
+}
+
+String Preferences::getString(const char *key, String defaultValue) {
+  size_t len = getBytesLength(key);
+  if (len == 0) {
+    return defaultValue;
+  }
+  return String(reinterpret_cast<const char *>(store()[fullKey(key)].data()));
+}
@@ -0,0 +1,117 @@
+/* Host Print shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "Print.h"
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    n += write(*buffer++);
+  }
+  return n;
+}
+
+size_t Print::write(const char *str) {
+  if (str == nullptr) {
+    return 0;
+  }
+  return write(str, strlen(str));
+}
+
+size_t Print::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  va_list copy;
+  va_copy(copy, args);
+  int len = vsnprintf(nullptr, 0, format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(args);
+    return 0;
+  }
+  std::vector<char> buf(len + 1);
+  vsnprintf(buf.data(), buf.size(), format, args);
+  va_end(args);
+  return write(buf.data(), len);
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+  return write(reinterpret_cast<const char *>(str));
+}
+size_t Print::print(const String &str) {
+  return write(str.c_str(), str.length());
+}
+size_t Print::print(const char str[]) { return write(str); }
+size_t Print::print(char c) { return write(static_cast<uint8_t>(c)); }
+size_t Print::print(unsigned char value, int base) {
+  return print(String(value, base));
+}
+size_t Print::print(int value, int base) { return print(String(value, base)); }
+size_t Print::print(unsigned int value, int base) {
+  return print(String(value, base));
+}
+size_t Print::print(long value, int base) { return print(String(value, base)); }
+size_t Print::print(unsigned long value, int base) {
+  return print(String(value, base));
+}
+size_t Print::print(long long value, int base) {
+  return print(String(value, base));
+}
+size_t Print::print(unsigned long long value, int base) {
+  return print(String(value, base));
+}
+size_t Print::print(double value, int digits) {
+  return print(String(value, digits));
+}
+
+/* Prints the time using strftime, the default format matches the Arduino-ESP32
+ * core.
+ */
+size_t Print::print(const struct tm *timeinfo, const char *format) {
+  char buf[64];
+  size_t n = strftime(buf, sizeof(buf),
+                      format ? format : "%c", timeinfo);
+  return write(buf, n);
+}
+
+#define PRINTLN(...)               \
+  {                                \
+    size_t n = print(__VA_ARGS__); \
+    return n + println();          \
+  }
+size_t Print::println(const __FlashStringHelper *str) PRINTLN(str)
+size_t Print::println(const String &str) PRINTLN(str)
+size_t Print::println(const char str[]) PRINTLN(str)
+size_t Print::println(char c) PRINTLN(c)
+size_t Print::println(unsigned char value, int base) PRINTLN(value, base)
+size_t Print::println(int value, int base) PRINTLN(value, base)
+size_t Print::println(unsigned int value, int base) PRINTLN(value, base)
+size_t Print::println(long value, int base) PRINTLN(value, base)
+size_t Print::println(unsigned long value, int base) PRINTLN(value, base)
+size_t Print::println(long long value, int base) PRINTLN(value, base)
+size_t Print::println(unsigned long long value, int base) PRINTLN(value, base)
+size_t Print::println(double value, int digits) PRINTLN(value, digits)
+size_t Print::println(const struct tm *timeinfo,
+                      const char *format) PRINTLN(timeinfo, format)
+#undef PRINTLN
+
+size_t Print::println() { return write("\r\n"); }
@@ -0,0 +1,334 @@
+/* Host String shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+#include "WString.h"
+
+/* Formats an unsigned integer in the given base, as Arduino's ultoa does.
+ */
+static std::string toBase(unsigned long long value, unsigned char base) {
+  if (base < 2 || base > 36) {
+    base = 10;
+  }
+  char buf[65];
+  char *p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do {
+    int digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  return p;
+}
+
+/* Formats a signed integer. As on Arduino, only base 10 gets a minus sign,
+ * other bases print the two's complement.
+ */
+static std::string toBaseSigned(long long value, unsigned char base,
+                                unsigned bits) {
+  if (base == 10 && value < 0) {
+    return "-" + toBase(-static_cast<unsigned long long>(value), base);
+  }
+  unsigned long long mask = bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+  return toBase(static_cast<unsigned long long>(value) & mask, base);
+}
+
+static std::string toFixed(double value, unsigned int decimalPlaces) {
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  return buf;
+}
+
+String::String(const char *cstr) : s(cstr ? cstr : "") {}
+String::String(const char *cstr, unsigned int length)
+    : s(cstr ? std::string(cstr, length) : std::string()) {}
+String::String(const __FlashStringHelper *str)
+    : String(reinterpret_cast<const char *>(str)) {}
+String::String(char c) : s(1, c) {}
+String::String(unsigned char value, unsigned char base)
+    : s(toBase(value, base)) {}
+String::String(int value, unsigned char base)
+    : s(toBaseSigned(value, base, 8 * sizeof(int))) {}
+String::String(unsigned int value, unsigned char base)
+    : s(toBase(value, base)) {}
+String::String(long value, unsigned char base)
+    : s(toBaseSigned(value, base, 8 * sizeof(long))) {}
+String::String(unsigned long value, unsigned char base)
+    : s(toBase(value, base)) {}
+String::String(long long value, unsigned char base)
+    : s(toBaseSigned(value, base, 64)) {}
+String::String(unsigned long long value, unsigned char base)
+    : s(toBase(value, base)) {}
+String::String(float value, unsigned int decimalPlaces)
+    : s(toFixed(value, decimalPlaces)) {}
+String::String(double value, unsigned int decimalPlaces)
+    : s(toFixed(value, decimalPlaces)) {}
+
+String &String::operator=(const char *cstr) {
+  s = cstr ? cstr : "";
+  return *this;
+}
+
+bool String::reserve(unsigned int size) {
+  s.reserve(size);
+  return true;
+}
+
+bool String::concat(const String &str) {
+  s += str.s;
+  return true;
+}
+bool String::concat(const char *cstr) {
+  if (!cstr) {
+    return false;
+  }
+  s += cstr;
+  return true;
+}
+bool String::concat(const char *cstr, unsigned int length) {
+  if (!cstr) {
+    return false;
+  }
+  s.append(cstr, length);
+  return true;
+}
+bool String::concat(char c) {
+  s += c;
+  return true;
+}
+bool String::concat(unsigned char value) { return concat(String(value)); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) {
+  return concat(String(value));
+}
+bool String::concat(float value) { return concat(String(value)); }
+bool String::concat(double value) { return concat(String(value)); }
+
+int String::compareTo(const String &str) const { return s.compare(str.s); }
+
+bool String::equals(const char *cstr) const {
+  return s == (cstr ? cstr : "");
+}
+
+bool String::equalsIgnoreCase(const String &str) const {
+  return s.length() == str.s.length()
+         && strcasecmp(s.c_str(), str.s.c_str()) == 0;
+}
+
+bool String::startsWith(const String &prefix) const {
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const {
+  return offset <= s.length() && s.compare(offset, prefix.s.length(),
+                                           prefix.s) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+  return s.length() >= suffix.s.length()
+         && s.compare(s.length() - suffix.s.length(), suffix.s.length(),
+                      suffix.s) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+  return index < s.length() ? s[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c) {
+  if (index < s.length()) {
+    s[index] = c;
+  }
+}
+
+char &String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= s.length()) {
+    dummy = '\0';
+    return dummy;
+  }
+  return s[index];
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize,
+                      unsigned int index) const {
+  if (!bufsize || !buf) {
+    return;
+  }
+  if (index >= s.length()) {
+    buf[0] = '\0';
+    return;
+  }
+  unsigned int n = std::min<unsigned int>(bufsize - 1, s.length() - index);
+  memcpy(buf, s.data() + index, n);
+  buf[n] = '\0';
+}
+
+void String::toCharArray(char *buf, unsigned int bufsize,
+                         unsigned int index) const {
+  getBytes(reinterpret_cast<unsigned char *>(buf), bufsize, index);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  size_t i = s.find(ch, fromIndex);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+int String::indexOf(const String &str, unsigned int fromIndex) const {
+  size_t i = s.find(str.s, fromIndex);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+int String::lastIndexOf(char ch) const {
+  size_t i = s.rfind(ch);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const {
+  size_t i = s.rfind(ch, fromIndex);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+int String::lastIndexOf(const String &str) const {
+  size_t i = s.rfind(str.s);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+int String::lastIndexOf(const String &str, unsigned int fromIndex) const {
+  size_t i = s.rfind(str.s, fromIndex);
+  return i == std::string::npos ? -1 : static_cast<int>(i);
+}
+
+String String::substring(unsigned int beginIndex) const {
+  return substring(beginIndex, s.length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    std::swap(beginIndex, endIndex);
+  }
+  if (beginIndex >= s.length()) {
+    return String();
+  }
+  endIndex = std::min<unsigned int>(endIndex, s.length());
+  return String(s.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::replace(char find, char replace) {
+  std::replace(s.begin(), s.end(), find, replace);
+}
+
+void String::replace(const String &find, const String &replace) {
+  if (find.s.empty()) {
+    return;
+  }
+  size_t pos = 0;
+  while ((pos = s.find(find.s, pos)) != std::string::npos) {
+    s.replace(pos, find.s.length(), replace.s);
+    pos += replace.s.length();
+  }
+}
+
+void String::remove(unsigned int index) {
+  remove(index, static_cast<unsigned int>(-1));
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index < s.length()) {
+    s.erase(index, count);
+  }
+}
+
+void String::toLowerCase() {
+  for (char &c : s) {
+    c = tolower(static_cast<unsigned char>(c));
+  }
+}
+
+void String::toUpperCase() {
+  for (char &c : s) {
+    c = toupper(static_cast<unsigned char>(c));
+  }
+}
+
+void String::trim() {
+  size_t b = 0;
+  size_t e = s.length();
+  while (b < e && isspace(static_cast<unsigned char>(s[b]))) {
+    ++b;
+  } while (e > b && isspace(static_cast<unsigned char>(s[e - 1]))) {
+    --e;
+  }
+  s = s.substr(b, e - b);
+}
+
+long String::toInt() const { return atol(s.c_str()); }
+float String::toFloat() const { return static_cast<float>(atof(s.c_str())); }
+double String::toDouble() const { return atof(s.c_str()); }
+
+StringSumHelper operator+(const String &lhs, const String &rhs) {
+  StringSumHelper r(lhs);
+  r.concat(rhs);
+  return r;
+}
+
+StringSumHelper operator+(const String &lhs, const char *rhs) {
+  StringSumHelper r(lhs);
+  r.concat(rhs);
+  return r;
+}
+
+StringSumHelper operator+(const char *lhs, const String &rhs) {
+  StringSumHelper r(lhs);
+  r.concat(rhs);
+  return r;
+}
+
+StringSumHelper operator+(const String &lhs, char rhs) {
+  StringSumHelper r(lhs);
+  r.concat(rhs);
+  return r;
+}
+
+StringSumHelper operator+(char lhs, const String &rhs) {
+  StringSumHelper r{String(lhs)};
+  r.concat(rhs);
+  return r;
+}
+
+#define STRING_SUM_NUMBER(T)                            \
+  StringSumHelper operator+(const String &lhs, T rhs) { \
+    StringSumHelper r(lhs);                             \
+    r.concat(rhs);                                      \
+    return r;                                           \
+  }
+STRING_SUM_NUMBER(int)
+STRING_SUM_NUMBER(unsigned int)
+STRING_SUM_NUMBER(long)
+STRING_SUM_NUMBER(unsigned long)
+STRING_SUM_NUMBER(float)
+STRING_SUM_NUMBER(double)
+#undef STRING_SUM_NUMBER
@@ -0,0 +1,264 @@
+/* Host WiFi and HTTP shims for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "HTTPClient.h"
+#include "WiFi.h"
+#include "WiFiClient.h"
+#include "native_env.h"
+
+WiFiClass WiFi;
+
+// registered event handlers, removed ones are left empty
+static std::vector<std::pair<arduino_event_id_t, WiFiEventFuncCb>> handlers;
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _addr[0], _addr[1], _addr[2],
+           _addr[3]);
+  return String(buf);
+}
+
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase) {
+  String mode = nativeEnv("NATIVE_WIFI", "ok");
+  if (mode == "nossid") {
+    _status = WL_NO_SSID_AVAIL;
+  } else if (mode == "fail") {
+    _status = WL_CONNECT_FAILED;
+  } else {
+    _status = WL_CONNECTED;
+    raise(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    raise(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  }
+  return _status;
+}
+
+bool WiFiClass::disconnect(bool wifioff, bool eraseap) {
+  if (_status == WL_CONNECTED) {
+    _status = WL_DISCONNECTED;
+    raise(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  }
+  return true;
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+  _mode = mode;
+  if (mode == WIFI_MODE_NULL) {
+    _status = WL_IDLE_STATUS;
+  }
+  return true;
+}
+
+int8_t WiFiClass::RSSI() {
+  return _status == WL_CONNECTED ? nativeEnvInt("NATIVE_RSSI", -60) : 0;
+}
+
+IPAddress WiFiClass::localIP() {
+  return _status == WL_CONNECTED ? IPAddress(192, 168, 0, 2) : IPAddress();
+}
+
+wifi_event_id_t WiFiClass::onEvent(WiFiEventFuncCb cb,
+                                   arduino_event_id_t event) {
+  handlers.emplace_back(event, cb);
+  return handlers.size();
+}
+
+void WiFiClass::removeEvent(wifi_event_id_t id) {
+  if (id > 0 && id <= handlers.size()) {
+    handlers[id - 1].second = nullptr;
+  }
+}
+
+void WiFiClass::raise(arduino_event_id_t event) {
+  for (auto &h : handlers) {
+    if (h.second && (h.first == event || h.first == ARDUINO_EVENT_MAX)) {
+      h.second(event, arduino_event_info_t{});
+    }
+  }
+}
+
+void WiFiClient::setReceived(std::string data) {
+  _rx = std::move(data);
+  _pos = 0;
+}
+
+int WiFiClient::available() { return _rx.size() - _pos; }
+
+int WiFiClient::read() {
+  return _pos < _rx.size() ? static_cast<uint8_t>(_rx[_pos++]) : -1;
+}
+
+int WiFiClient::peek() {
+  return _pos < _rx.size() ? static_cast<uint8_t>(_rx[_pos]) : -1;
+}
+
+size_t WiFiClient::readBytes(char *buffer, size_t length) {
+  size_t n = std::min(length, _rx.size() - _pos);
+  memcpy(buffer, _rx.data() + _pos, n);
+  _pos += n;
+  return n;
+}
+
+void WiFiClient::stop() {
+  _rx.clear();
+  _pos = 0;
+}
+
+bool HTTPClient::begin(WiFiClient &client, String host, uint16_t port,
+                       String uri, bool https) {
+  _client = &client;
+  _host = host;
+  _port = port;
+  _uri = uri;
+  return true;
+}
+
+void HTTPClient::end() {
+  if (_client) {
+    _client->stop();
+  }
+  _client = nullptr;
+  _size = -1;
+}
+
+/* Sends an HTTP/1.0 GET to server ("host:port") and returns the raw response,
+ * or an HTTPC_ERROR_* code in err.
+ */
+static std::string forwardGet(const std::string &server,
+                              const std::string &host, const std::string &uri,
+                              int32_t connectTimeout, uint16_t timeout,
+                              int &err) {
+  err = 0;
+  size_t colon = server.rfind(':');
+  std::string name = server.substr(0, colon);
+  std::string port = colon == std::string::npos ? "80"
+                                                : server.substr(colon + 1);
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *res = nullptr;
+  if (getaddrinfo(name.c_str(), port.c_str(), &hints, &res) != 0) {
+    err = HTTPC_ERROR_CONNECTION_REFUSED;
+    return "";
+  }
+  int fd = -1;
+  for (addrinfo *ai = res; ai != nullptr && fd < 0; ai = ai->ai_next) {
+    fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+    if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+      close(fd);
+      fd = -1;
+    }
+  }
+  freeaddrinfo(res);
+  if (fd < 0) {
+    err = HTTPC_ERROR_CONNECTION_REFUSED;
+    return "";
+  }
+  timeval tv = {timeout / 1000, (timeout % 1000) * 1000};
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+
+  std::string request = "GET " + uri + " HTTP/1.0\r\nHost: " + host
+                        + "\r\nUser-Agent: ESP32HTTPClient\r\n"
+                          "Connection: close\r\n\r\n";
+  if (send(fd, request.data(), request.size(), 0)
+      != static_cast<ssize_t>(request.size())) {
+    close(fd);
+    err = HTTPC_ERROR_SEND_HEADER_FAILED;
+    return "";
+  }
+  std::string response;
+  char buf[4096];
+  ssize_t n;
+  while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) {
+    response.append(buf, n);
+  }
+  close(fd);
+  if (n < 0) {
+    err = HTTPC_ERROR_READ_TIMEOUT;
+  }
+  return response;
+}
+
+int HTTPClient::GET() {
+  if (_client == nullptr) {
+    return HTTPC_ERROR_NOT_CONNECTED;
+  }
+
+  const char *file = nativeEnv("NATIVE_HTTP_FILE", nullptr);
+  if (file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    std::ostringstream body;
+    body << in.rdbuf();
+    _client->setReceived(body.str());
+    _size = _client->available();
+    return HTTP_CODE_OK;
+  }
+
+  const char *server = nativeEnv("NATIVE_HTTP_SERVER", nullptr);
+  if (server == nullptr) {
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  int err;
+  std::string response = forwardGet(server, _host.c_str(), _uri.c_str(),
+                                    _connectTimeout, _timeout, err);
+  if (err) {
+    return err;
+  }
+  int code = 0;
+  size_t headerEnd = response.find("\r\n\r\n");
+  if (headerEnd == std::string::npos
+      || sscanf(response.c_str(), "HTTP/%*d.%*d %d", &code) != 1) {
+    return HTTPC_ERROR_NO_HTTP_SERVER;
+  }
+  _client->setReceived(response.substr(headerEnd + 4));
+  _size = _client->available();
+  return code;
+}
+
+String HTTPClient::getString() {
+  return _client ? _client->readString() : String();
+}
+
+String HTTPClient::errorToString(int error) {
+  switch (error) {
+  case HTTPC_ERROR_CONNECTION_REFUSED:
+    return "connection refused";
+  case HTTPC_ERROR_SEND_HEADER_FAILED:
+    return "send header failed";
+  case HTTPC_ERROR_NOT_CONNECTED:
+    return "not connected";
+  case HTTPC_ERROR_NO_HTTP_SERVER:
+    return "no HTTP server";
+  case HTTPC_ERROR_READ_TIMEOUT:
+    return "read Timeout";
+  default:
+    return String();
+  }
+}
@@ -0,0 +1,94 @@
+/* Host partition API shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstring>
+#include <vector>
+
+#include "esp_partition.h"
+
+static const esp_partition_t SPIFFS_PARTITION = {
+    nullptr, ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS,
+    0x310000, 0xE0000, "spiffs", false};
+
+static std::vector<uint8_t> &flash() {
+  static std::vector<uint8_t> data(SPIFFS_PARTITION.size, 0xFF);
+  return data;
+}
+
+static bool inRange(const esp_partition_t *partition, size_t offset,
+                    size_t size) {
+  return partition == &SPIFFS_PARTITION && offset <= partition->size
+         && size <= partition->size - offset;
+}
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label) {
+  if (type != SPIFFS_PARTITION.type
+      || (subtype != SPIFFS_PARTITION.subtype
+          && subtype != ESP_PARTITION_SUBTYPE_ANY)
+      || (label != nullptr && strcmp(label, SPIFFS_PARTITION.label) != 0)) {
+    return nullptr;
+  }
+  return &SPIFFS_PARTITION;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *partition,
+                             size_t src_offset, void *dst, size_t size) {
+  if (!inRange(partition, src_offset, size)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memcpy(dst, flash().data() + src_offset, size);
+  return ESP_OK;
+}
+
+/* Like NOR flash, writing can only clear bits, erasing sets them again.
+ */
+esp_err_t esp_partition_write(const esp_partition_t *partition,
+                              size_t dst_offset, const void *src, size_t size) {
+  if (!inRange(partition, dst_offset, size)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const uint8_t *s = static_cast<const uint8_t *>(src);
+  for (size_t i = 0; i < size; ++i) {
+    flash()[dst_offset + i] &= s[i];
+  }
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *partition,
+                                    size_t offset, size_t size) {
+  if (!inRange(partition, offset, size) || offset % SPI_FLASH_SEC_SIZE != 0
+      || size % SPI_FLASH_SEC_SIZE != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(flash().data() + offset, 0xFF, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_mmap(const esp_partition_t *partition, size_t offset,
+                             size_t size, esp_partition_mmap_memory_t memory,
+                             const void **out_ptr,
+                             spi_flash_mmap_handle_t *out_handle) {
+  if (!inRange(partition, offset, size)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  *out_ptr = flash().data() + offset;
+  *out_handle = 1;
+  return ESP_OK;
+}
+
+void spi_flash_munmap(spi_flash_mmap_handle_t handle) {}
@@ -0,0 +1,60 @@
+/* Host ESP-IDF sleep shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <cstdlib>
+
+#include "Arduino.h"
+#include "GxEPD2_EPD.h"
+#include "esp_sleep.h"
+#include "native_env.h"
+
+static uint64_t timerWakeup = 0;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us) {
+  timerWakeup = time_in_us;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+  if (source == ESP_SLEEP_WAKEUP_TIMER || source == ESP_SLEEP_WAKEUP_ALL) {
+    timerWakeup = 0;
+  }
+  return ESP_OK;
+}
+
+/* Every run is a fresh boot, or a timer wake if NATIVE_WAKE=timer.
+ */
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  return String(nativeEnv("NATIVE_WAKE", "")) == "timer"
+             ? ESP_SLEEP_WAKEUP_TIMER
+             : ESP_SLEEP_WAKEUP_UNDEFINED;
+}
+
+esp_err_t esp_light_sleep_start() { return ESP_OK; }
+
+void esp_deep_sleep_start() {
+  const char *prefix = nativeEnv("NATIVE_FRAME", "frame");
+  Serial.printf("[native] deep sleep for %llus, saving panel to %s.png\n",
+                static_cast<unsigned long long>(timerWakeup / 1000000),
+                prefix);
+  Serial.flush();
+  bool ok = GxEPD2_EPD::saveAll(prefix);
+  fflush(stdout);
+  exit(ok ? 0 : 1);
+}
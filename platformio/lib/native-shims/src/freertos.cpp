@@ -0,0 +1,176 @@
+/* Host FreeRTOS shim for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct NativeSemaphore {
+  std::mutex m;
+  std::condition_variable cv;
+  UBaseType_t count;
+  UBaseType_t maxCount;
+};
+
+struct NativeEventGroup {
+  std::mutex m;
+  std::condition_variable cv;
+  EventBits_t bits = 0;
+};
+
+/* Waits on cv until pred is true or ticks have passed. */
+template <typename Pred>
+static bool waitTicks(std::condition_variable &cv,
+                      std::unique_lock<std::mutex> &lock, TickType_t ticks,
+                      Pred pred) {
+  if (ticks == portMAX_DELAY) {
+    cv.wait(lock, pred);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(ticks), pred);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount,
+                                           UBaseType_t initialCount) {
+  SemaphoreHandle_t s = new NativeSemaphore;
+  s->count = initialCount;
+  s->maxCount = maxCount;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) { delete semaphore; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  std::unique_lock<std::mutex> lock(semaphore->m);
+  if (!waitTicks(semaphore->cv, lock, ticks,
+                 [&] { return semaphore->count > 0; })) {
+    return pdFALSE;
+  }
+  --semaphore->count;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  std::lock_guard<std::mutex> lock(semaphore->m);
+  if (semaphore->count >= semaphore->maxCount) {
+    return pdFALSE;
+  }
+  ++semaphore->count;
+  semaphore->cv.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore,
+                                 BaseType_t *higherPriorityTaskWoken) {
+  if (higherPriorityTaskWoken) {
+    *higherPriorityTaskWoken = pdFALSE;
+  }
+  return xSemaphoreGive(semaphore);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t taskCode, const char *name,
+                                   uint32_t stackDepth, void *parameters,
+                                   UBaseType_t priority,
+                                   TaskHandle_t *createdTask,
+                                   BaseType_t coreId) {
+  std::thread(taskCode, parameters).detach();
+  if (createdTask) {
+    // only used as an opaque, non-null handle
+    static int taskCount = 0;
+    *createdTask = reinterpret_cast<TaskHandle_t>(++taskCount);
+  }
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t taskCode, const char *name,
+                       uint32_t stackDepth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *createdTask) {
+  return xTaskCreatePinnedToCore(taskCode, name, stackDepth, parameters,
+                                 priority, createdTask, tskNO_AFFINITY);
+}
+
+/* A task deleting itself simply returns from its function, which ends the
+ * thread. Deleting another task is not supported.
+ */
+void vTaskDelete(TaskHandle_t task) {}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks));
+}
+
+TickType_t xTaskGetTickCount() {
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+EventGroupHandle_t xEventGroupCreate() { return new NativeEventGroup; }
+
+void vEventGroupDelete(EventGroupHandle_t group) { delete group; }
+
+EventBits_t xEventGroupSetBits(EventGroupHandle_t group,
+                               const EventBits_t bitsToSet) {
+  std::lock_guard<std::mutex> lock(group->m);
+  group->bits |= bitsToSet;
+  group->cv.notify_all();
+  return group->bits;
+}
+
+EventBits_t xEventGroupClearBits(EventGroupHandle_t group,
+                                 const EventBits_t bitsToClear) {
+  std::lock_guard<std::mutex> lock(group->m);
+  EventBits_t bits = group->bits;
+  group->bits &= ~bitsToClear;
+  return bits;
+}
+
+EventBits_t xEventGroupGetBits(EventGroupHandle_t group) {
+  std::lock_guard<std::mutex> lock(group->m);
+  return group->bits;
+}
+
+EventBits_t xEventGroupWaitBits(EventGroupHandle_t group,
+                                const EventBits_t bitsToWaitFor,
+                                const BaseType_t clearOnExit,
+                                const BaseType_t waitForAllBits,
+                                TickType_t ticksToWait) {
+  std::unique_lock<std::mutex> lock(group->m);
+  auto done = [&] {
+    EventBits_t set = group->bits & bitsToWaitFor;
+    return waitForAllBits ? set == bitsToWaitFor : set != 0;
+  };
+  bool ok = waitTicks(group->cv, lock, ticksToWait, done);
+  EventBits_t bits = group->bits;
+  if (ok && clearOnExit) {
+    group->bits &= ~bitsToWaitFor;
+  }
+  return bits;
+}
@@ -0,0 +1,163 @@
+/* 1-bit image files for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+#include <vector>
+
+#include "native_image.h"
+
+/* Writes a binary PBM (P4). PBM uses 1 for black, so the bits are inverted.
+ */
+bool writePBM(const char *path, const uint8_t *bits, uint16_t w, uint16_t h) {
+  FILE *f = fopen(path, "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  size_t rowBytes = (w + 7) / 8;
+  std::vector<uint8_t> row(rowBytes);
+  fprintf(f, "P4\n%u %u\n", w, h);
+  for (uint16_t y = 0; y < h; ++y) {
+    for (size_t i = 0; i < rowBytes; ++i) {
+      row[i] = ~bits[y * rowBytes + i];
+    }
+    fwrite(row.data(), 1, rowBytes, f);
+  }
+  return fclose(f) == 0;
+} // end writePBM
+
+/* Reads a binary PBM (P4) written by writePBM. Comments in the header are not
+ * supported.
+ */
+bool readPBM(const char *path, std::vector<uint8_t> &bits, uint16_t &w,
+             uint16_t &h) {
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  unsigned int fw = 0;
+  unsigned int fh = 0;
+  if (fscanf(f, "P4 %u %u", &fw, &fh) != 2 || fgetc(f) == EOF || fw == 0
+      || fh == 0 || fw > UINT16_MAX || fh > UINT16_MAX) {
+    fclose(f);
+    return false;
+  }
+  w = fw;
+  h = fh;
+  bits.resize((w + 7) / 8 * h);
+  bool ok = fread(bits.data(), 1, bits.size(), f) == bits.size();
+  fclose(f);
+  for (uint8_t &b : bits) {
+    b = ~b;
+  }
+  return ok;
+} // end readPBM
+
+static uint32_t crc32(uint32_t crc, const uint8_t *data, size_t len) {
+  // built on first use, thread-safe as a function-local static
+  static const std::vector<uint32_t> table = [] {
+    std::vector<uint32_t> t(256);
+    for (uint32_t n = 0; n < 256; ++n) {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k) {
+        c = (c & 1) ? 0xEDB88320 ^ (c >> 1) : c >> 1;
+      }
+      t[n] = c;
+    }
+    return t;
+  }();
+  crc = ~crc;
+  for (size_t i = 0; i < len; ++i) {
+    crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  }
+  return ~crc;
+} // end crc32
+
+static void putU32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24);
+  out.push_back(v >> 16);
+  out.push_back(v >> 8);
+  out.push_back(v);
+}
+
+static bool writeChunk(FILE *f, const char *type,
+                       const std::vector<uint8_t> &data) {
+  std::vector<uint8_t> chunk;
+  putU32(chunk, data.size());
+  chunk.insert(chunk.end(), type, type + 4);
+  chunk.insert(chunk.end(), data.begin(), data.end());
+  putU32(chunk, crc32(0, chunk.data() + 4, chunk.size() - 4));
+  return fwrite(chunk.data(), 1, chunk.size(), f) == chunk.size();
+}
+
+/* Writes a 1-bit grayscale PNG. 1 is white in PNG too, so the rows are copied
+ * as they are. The image data is stored uncompressed (deflate "stored"
+ * blocks), which keeps this short and is still far smaller than a PPM.
+ */
+bool writePNG(const char *path, const uint8_t *bits, uint16_t w, uint16_t h) {
+  size_t rowBytes = (w + 7) / 8;
+
+  // filter type 0 (none) in front of every row
+  std::vector<uint8_t> raw;
+  raw.reserve((rowBytes + 1) * h);
+  for (uint16_t y = 0; y < h; ++y) {
+    raw.push_back(0);
+    raw.insert(raw.end(), bits + y * rowBytes, bits + (y + 1) * rowBytes);
+  }
+
+  std::vector<uint8_t> idat = {0x78, 0x01}; // zlib header, no compression
+  size_t pos = 0;
+  do {
+    size_t len = raw.size() - pos;
+    if (len > 0xFFFF) {
+      len = 0xFFFF;
+    }
+    idat.push_back(pos + len == raw.size() ? 1 : 0); // BFINAL, BTYPE=00
+    idat.push_back(len & 0xFF);
+    idat.push_back(len >> 8);
+    idat.push_back(~len & 0xFF);
+    idat.push_back((~len >> 8) & 0xFF);
+    idat.insert(idat.end(), raw.begin() + pos, raw.begin() + pos + len);
+    pos += len;
+  } while (pos < raw.size());
+
+  uint32_t a = 1;
+  uint32_t b = 0;
+  for (uint8_t c : raw) {
+    a = (a + c) % 65521;
+    b = (b + a) % 65521;
+  }
+  putU32(idat, (b << 16) | a);
+
+  std::vector<uint8_t> ihdr;
+  putU32(ihdr, w);
+  putU32(ihdr, h);
+  ihdr.push_back(1); // bit depth
+  ihdr.push_back(0); // grayscale
+  ihdr.push_back(0); // deflate
+  ihdr.push_back(0); // adaptive filtering
+  ihdr.push_back(0); // no interlace
+
+  FILE *f = fopen(path, "wb");
+  if (f == nullptr) {
+    return false;
+  }
+  static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A,
+                                       '\n'};
+  bool ok = fwrite(signature, 1, sizeof(signature), f) == sizeof(signature)
+            && writeChunk(f, "IHDR", ihdr) && writeChunk(f, "IDAT", idat)
+            && writeChunk(f, "IEND", {});
+  return fclose(f) == 0 && ok;
+} // end writePNG
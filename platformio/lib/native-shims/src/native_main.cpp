@@ -0,0 +1,29 @@
+/* Host entry point for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cstdio>
+
+#include "Arduino.h"
+
+/* The firmware does all of its work in setup() and ends it in deep sleep,
+ * which exits the process. Host tools that want to drive the firmware code
+ * themselves leave this file out and provide their own main().
+ */
+int main() {
+  setup();
+  fprintf(stderr, "[native] setup() returned without entering deep sleep\n");
+  return 1;
+}
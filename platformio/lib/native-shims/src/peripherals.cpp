@@ -0,0 +1,48 @@
+/* Host peripheral shims for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+
+#include "Adafruit_BME280.h"
+#include "SPI.h"
+#include "WString.h"
+#include "Wire.h"
+#include "native_env.h"
+
+TwoWire Wire;
+SPIClass SPI;
+
+bool Adafruit_BME280::begin(uint8_t addr, TwoWire *theWire) {
+  _found = String(nativeEnv("NATIVE_BME", "ok")) != "absent";
+  return _found;
+}
+
+float Adafruit_BME280::readTemperature() {
+  return _found ? nativeEnvFloat("NATIVE_BME_TEMP", 21.5) : NAN;
+}
+
+float Adafruit_BME280::readPressure() {
+  return _found ? 101325.0f : NAN;
+}
+
+float Adafruit_BME280::readHumidity() {
+  return _found ? nativeEnvFloat("NATIVE_BME_HUMIDITY", 45.0) : NAN;
+}
+
+float Adafruit_BME280::readAltitude(float seaLevel) {
+  float atmospheric = readPressure() / 100.0f;
+  return 44330.0f * (1.0f - powf(atmospheric / seaLevel, 0.1903f));
+}
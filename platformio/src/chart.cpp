@@ -0,0 +1,373 @@
+/* Chart engine for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include <Arduino.h>
+#include <GxEPD2.h>
+
+#include "chart.h"
+
+/* Returns an axis with ticks steps from min to max that holds lo to hi.
+ *
+ * The step is the smallest "nice" number, 1, 2 or 5 times a power of ten, of
+ * at least minStep that does so, and min and max are multiples of it. Whole
+ * steps left over are split between both ends, so that the values sit in the
+ * middle, except that an axis of positive values never goes below zero.
+ */
+chart_axis_t niceAxis(float lo, float hi, uint8_t ticks, float minStep) {
+  static const float nice[] = {1, 2, 5, 10, 20};
+  if (hi < lo) {
+    std::swap(lo, hi);
+  }
+  float raw = std::max((hi - lo) / ticks, minStep);
+  if (raw <= 0) {
+    raw = 1; // all the same, with no step to fall back on
+  }
+  float magnitude = std::pow(10.0f, std::floor(std::log10(raw)));
+  int k = 0;
+  while (nice[k] * magnitude < raw * 0.9999f) {
+    ++k;
+  }
+  float step = nice[k] * magnitude;
+  float min = std::floor(lo / step) * step;
+  // aligning min can cost up to a step, the next nice step is at least twice
+  // as large and always makes up for it
+  if (min + ticks * step < hi) {
+    step = nice[k + 1] * magnitude;
+    min = std::floor(lo / step) * step;
+  }
+
+  int down = static_cast<int>((min + ticks * step - hi) / step) / 2;
+  if (lo >= 0) {
+    down = std::min(down, static_cast<int>(std::round(min / step)));
+  }
+  min -= down * step;
+
+  uint8_t decimals = 0;
+  if (step < 1) {
+    decimals = static_cast<uint8_t>(std::ceil(-std::log10(step) - 1e-3f));
+  }
+  return {min, min + ticks * step, step, decimals};
+} // end niceAxis
+
+/* Draws a series as a line through its points, with round joins.
+ */
+void chartLine(DisplayList &gfx, const Chart &chart,
+               const chart_series_t &series) {
+  int16_t x[CHART_POINTS];
+  for (uint8_t i = 0; i < series.points; ++i) {
+    x[i] = chart.sampleX(series.sample[i]);
+  }
+  gfx.drawPolyline(x, series.y, series.points, series.width, DL_JOIN_ROUND,
+                   series.color);
+  return;
+} // end chartLine
+
+/* Draws a series as solid bars, across the slots of the samples of each
+ * point.
+ */
+void chartBars(DisplayList &gfx, const Chart &chart,
+               const chart_series_t &series) {
+  int16_t bottom = chart.bottom() - 1; // above the x axis
+  for (uint8_t i = 0; i < series.points; ++i) {
+    int16_t x0 = chart.slotLeft(series.sample[i]);
+    int16_t x1 = chart.slotLeft(i + 1 < series.points ? series.sample[i + 1]
+                                                      : chart.samples());
+    gfx.fillRect(x0, series.y[i] + 1, x1 - x0, bottom - series.y[i],
+                 series.color);
+  }
+  return;
+} // end chartBars
+
+/* Draws a series as bars filled with every other pixel of every other row,
+ * which leave lines drawn over them readable.
+ */
+void chartHatched(DisplayList &gfx, const Chart &chart,
+                  const chart_series_t &series) {
+  int16_t bottom = chart.bottom() - 1; // above the x axis
+  for (uint8_t i = 0; i < series.points; ++i) {
+    int16_t x0 = chart.slotLeft(series.sample[i]);
+    int16_t x1 = chart.slotLeft(i + 1 < series.points ? series.sample[i + 1]
+                                                      : chart.samples());
+    // aligned to the bottom row, so that all bars start with a full row
+    gfx.fillPattern(x0, series.y[i] + 1, x1 - x0, bottom - series.y[i],
+                    DL_PATTERN_DOTS, series.color, 0, bottom);
+  }
+  return;
+} // end chartHatched
+
+/* Picks out points of n values, the first and the last, and in between the
+ * one of each of points - 2 buckets that spans the largest triangle with the
+ * point picked before it and the average of the next bucket. Peaks and dips
+ * take large triangles, so the line keeps its shape.
+ */
+static void lttb(const float *values, uint16_t n, uint8_t points,
+                 uint16_t *sample) {
+  float every = (n - 2) / static_cast<float>(points - 2);
+  uint16_t a = 0;
+  sample[0] = 0;
+  for (uint8_t b = 0; b + 2 < points; ++b) {
+    uint16_t start = static_cast<uint16_t>(b * every) + 1;
+    uint16_t end = static_cast<uint16_t>((b + 1) * every) + 1;
+    uint16_t nextEnd =
+        std::min<uint16_t>(static_cast<uint16_t>((b + 2) * every) + 1, n);
+    float avgX = 0;
+    float avgY = 0;
+    for (uint16_t i = end; i < nextEnd; ++i) {
+      avgX += i;
+      avgY += values[i];
+    }
+    avgX /= nextEnd - end;
+    avgY /= nextEnd - end;
+
+    float maxArea = -1;
+    for (uint16_t i = start; i < end; ++i) {
+      // twice the area, which picks the same point
+      float area = std::fabs((a - avgX) * (values[i] - values[a])
+                             - (a - i) * (avgY - values[a]));
+      if (area > maxArea) {
+        maxArea = area;
+        sample[b + 1] = i;
+      }
+    }
+    a = sample[b + 1];
+  }
+  sample[points - 1] = n - 1;
+  return;
+} // end lttb
+
+/* Fills in the values of a series from one per sample. More samples than
+ * CHART_POINTS are decimated, and only the points picked are kept.
+ */
+void Chart::setValues(chart_series_t &series, const float *values,
+                      chart_decimation_t decimation) const {
+  series.lo = series.hi = values[0];
+  for (uint16_t i = 1; i < _samples; ++i) {
+    series.lo = std::min(series.lo, values[i]);
+    series.hi = std::max(series.hi, values[i]);
+  }
+
+  series.points = std::min<uint16_t>(_samples, CHART_POINTS);
+  if (series.points == _samples) {
+    for (uint16_t i = 0; i < _samples; ++i) {
+      series.sample[i] = i;
+    }
+  } else if (decimation == CHART_LTTB) {
+    lttb(values, _samples, series.points, series.sample);
+  } else {
+    for (uint8_t b = 0; b < series.points; ++b) {
+      series.sample[b] = b * _samples / series.points;
+    }
+  }
+
+  for (uint8_t i = 0; i < series.points; ++i) {
+    uint16_t first = series.sample[i];
+    series.value[i] = values[first];
+    if (decimation == CHART_MAX) {
+      uint16_t end =
+          i + 1 < series.points ? series.sample[i + 1] : _samples;
+      series.value[i] = *std::max_element(values + first, values + end);
+    }
+  }
+  return;
+} // end setValues
+
+/* The chart covers left to right and top to bottom, with samples slots of
+ * the same width along it and ticks grid lines up it.
+ */
+Chart::Chart(int16_t left, int16_t top, int16_t right, int16_t bottom,
+             uint16_t samples, uint8_t ticks)
+    : _left(left), _top(top), _right(right), _bottom(bottom),
+      _samples(samples), _ticks(ticks),
+      _interval((right - left - 1) / static_cast<float>(samples)), _size(0) {}
+
+/* Returns a new series, or nullptr if the chart already has CHART_SERIES.
+ * Its values, see setValues(), and axis are for the caller to fill in.
+ */
+chart_series_t *Chart::addSeries(chart_renderer_t render, uint16_t color,
+                                 uint8_t width) {
+  if (_size == CHART_SERIES) {
+    return nullptr;
+  }
+  chart_series_t &s = _series[_size++];
+  s.points = 0;
+  s.lo = s.hi = 0;
+  s.axis = {0, 1, 1, 0};
+  s.render = render;
+  s.color = color;
+  s.width = width;
+  return &s;
+} // end addSeries
+
+/* Computes the y coordinate of every point, once the values and axes of all
+ * series are filled in.
+ */
+void Chart::layout() {
+  for (size_t n = 0; n < _size; ++n) {
+    chart_series_t &s = _series[n];
+    float pxPerUnit = (_bottom - _top) / (s.axis.max - s.axis.min);
+    for (uint8_t i = 0; i < s.points; ++i) {
+      s.y[i] = static_cast<int16_t>(
+          std::round(_bottom - pxPerUnit * (s.value[i] - s.axis.min)));
+    }
+  }
+  return;
+} // end layout
+
+/* Draws the grid, the x axis and then every series.
+ */
+void Chart::draw(DisplayList &gfx) const {
+  gfx.drawLine(_left, _bottom, _right, _bottom, GxEPD_BLACK);
+  gfx.drawLine(_left, _bottom - 1, _right, _bottom - 1, GxEPD_BLACK);
+  for (uint8_t t = 0; t < _ticks; ++t) {
+    int16_t y = gridY(t);
+    // moved to an even row
+    gfx.drawPatternHLine(_left, y + (y % 2), _right + 2 - _left,
+                         DL_PATTERN_DOTTED_H, GxEPD_BLACK, _left);
+  }
+  for (size_t n = 0; n < _size; ++n) {
+    _series[n].render(gfx, *this, _series[n]);
+  }
+  return;
+} // end draw
+
+/* Returns the column at the center of the slot of sample i.
+ */
+int16_t Chart::sampleX(uint16_t i) const {
+  return static_cast<int16_t>(
+      std::round(_left + i * _interval + 0.5f * _interval));
+} // end sampleX
+
+/* Returns the first column of the slot of sample i, or the end of the last
+ * slot for i == samples().
+ */
+int16_t Chart::slotLeft(uint16_t i) const {
+  return static_cast<int16_t>(std::round(_left + 1 + i * _interval));
+} // end slotLeft
+
+/* Returns the column of the tick mark at the start of the slot of sample i,
+ * just left of it.
+ */
+int16_t Chart::tickX(uint16_t i) const {
+  return slotLeft(i) - 1;
+} // end tickX
+
+/* Returns the row of grid line tick, counted from the top. Grid line ticks()
+ * is the x axis.
+ */
+int16_t Chart::gridY(uint8_t tick) const {
+  return static_cast<int16_t>(_top + tick * (_bottom - _top)
+                                         / static_cast<float>(_ticks));
+} // end gridY
+
+/* Places n marks, w by h pixels and in order of their samples, centered on
+ * the tick marks of their samples. Each goes right above the line, or right
+ * below it if there is no room above between minY and the line. Marks that
+ * would stick out of the sides of the chart, where the axis labels are, that
+ * fit neither above nor below the line, or that would overlap the mark placed
+ * before them, are left out.
+ *
+ * The highest and lowest row of the line under each mark are sliding window
+ * extremes, found with a monotonic queue of points each, so that placing all
+ * marks takes time linear in the number of points and marks.
+ */
+void Chart::placeMarks(const chart_series_t &line, chart_mark_t *marks,
+                       uint8_t n, int16_t w, int16_t h, int16_t minY) const {
+  int16_t x[CHART_POINTS];
+  for (uint8_t i = 0; i < line.points; ++i) {
+    x[i] = sampleX(line.sample[i]);
+  }
+  // the points under the window, by increasing y (top) and decreasing y
+  // (bottom), every point enters and leaves each queue at most once
+  uint8_t top[CHART_POINTS], bottom[CHART_POINTS];
+  uint8_t topHead = 0, topTail = 0, bottomHead = 0, bottomTail = 0;
+  uint8_t next = 0;    // the first point right of the window
+  uint8_t segment = 0; // the segment the left edge of the window is on
+
+  // the row of the line at column c, on the segment that starts at point k
+  auto rowAt = [&](uint8_t k, int16_t c) -> int16_t {
+    if (k + 1 >= line.points || x[k + 1] == x[k]) {
+      return line.y[k];
+    }
+    float m = (line.y[k + 1] - line.y[k])
+              / static_cast<float>(x[k + 1] - x[k]);
+    return static_cast<int16_t>(std::round(line.y[k] + m * (c - x[k])));
+  };
+
+  const chart_mark_t *last = nullptr;
+  for (uint8_t i = 0; i < n; ++i) {
+    chart_mark_t &mark = marks[i];
+    mark.x = tickX(mark.sample) - w / 2;
+    mark.y = INT16_MAX;
+    int16_t x0 = mark.x;
+    int16_t x1 = mark.x + w;
+
+    while (next < line.points && x[next] <= x1) {
+      while (topTail > topHead && line.y[top[topTail - 1]] >= line.y[next]) {
+        --topTail;
+      }
+      top[topTail++] = next;
+      while (bottomTail > bottomHead
+             && line.y[bottom[bottomTail - 1]] <= line.y[next]) {
+        --bottomTail;
+      }
+      bottom[bottomTail++] = next;
+      ++next;
+    }
+    while (topHead < topTail && x[top[topHead]] < x0) {
+      ++topHead;
+    }
+    while (bottomHead < bottomTail && x[bottom[bottomHead]] < x0) {
+      ++bottomHead;
+    }
+    while (segment + 1 < line.points && x[segment + 1] < x0) {
+      ++segment;
+    }
+    if (line.points == 0 || x[0] > x1 || x[line.points - 1] < x0
+        || x0 < _left || x1 > _right) {
+      continue;
+    }
+
+    // the line where it crosses the edges of the window, and its points
+    // in between
+    int16_t yl = rowAt(segment, std::max(x0, x[0]));
+    int16_t yr =
+        rowAt(next > 0 ? next - 1 : 0, std::min(x1, x[line.points - 1]));
+    int16_t lineTop = std::min(yl, yr);
+    int16_t lineBottom = std::max(yl, yr);
+    if (topHead < topTail) {
+      lineTop = std::min(lineTop, line.y[top[topHead]]);
+      lineBottom = std::max(lineBottom, line.y[bottom[bottomHead]]);
+    }
+
+    int16_t y = lineTop - h;
+    if (y < minY) {
+      y = lineBottom + 1;
+      if (y + h > _bottom - 1) {
+        continue; // no room below either, above the x axis
+      }
+    }
+    if (last && last->x + w > x0 && last->y < y + h && y < last->y + h) {
+      continue;
+    }
+    mark.y = y;
+    last = &mark;
+  }
+  return;
+} // end placeMarks
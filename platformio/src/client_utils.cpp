@@ -25,6 +25,8 @@
 #include <SPI.h>
 #include <WiFi.h>
 #include <esp_sntp.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/event_groups.h>
 #include <time.h>
 
 
@@ -40,7 +42,9 @@
 #include "client_utils.h"
 #include "config.h"
 #include "display_utils.h"
+#include "power_utils.h"
 #include "renderer.h"
+#include "wake_budget.h"
 #ifndef USE_HTTP
 #include <WiFiClientSecure.h>
 #endif
@@ -51,6 +55,32 @@ static const uint16_t OWM_PORT = 80;
 static const uint16_t OWM_PORT = 443;
 #endif
 
+// Event group bits used to block on network events instead of polling.
+#define NET_WIFI_GOT_IP BIT0
+#define NET_SNTP_SYNCED BIT1
+static EventGroupHandle_t netEvents = nullptr;
+
+/* Returns the network event group, creating it on first use.
+ */
+static EventGroupHandle_t getNetEvents() {
+  if (netEvents == nullptr) {
+    netEvents = xEventGroupCreate();
+  }
+  return netEvents;
+} // getNetEvents
+
+/* Called from the WiFi event task once an IP address has been assigned.
+ */
+static void onWiFiGotIP(WiFiEvent_t event, WiFiEventInfo_t info) {
+  xEventGroupSetBits(getNetEvents(), NET_WIFI_GOT_IP);
+} // onWiFiGotIP
+
+/* Called from the SNTP task once the system time has been set.
+ */
+static void onSNTPSync(struct timeval *tv) {
+  xEventGroupSetBits(getNetEvents(), NET_SNTP_SYNCED);
+} // onSNTPSync
+
 /* Power-on and connect WiFi.
  * Takes int parameter to store WiFi RSSI, or “Received Signal Strength
  * Indicator"
@@ -58,20 +88,25 @@ static const uint16_t OWM_PORT = 443;
  * Returns WiFi status.
  */
 wl_status_t startWiFi(int &wifiRSSI) {
+  xEventGroupClearBits(getNetEvents(), NET_WIFI_GOT_IP);
+  wifi_event_id_t eventId =
+      WiFi.onEvent(onWiFiGotIP, ARDUINO_EVENT_WIFI_STA_GOT_IP);
   WiFi.mode(WIFI_STA);
-  Serial.printf("%s '%s'", TXT_CONNECTING_TO, WIFI_SSID);
+  Serial.printf("%s '%s'\n", TXT_CONNECTING_TO, WIFI_SSID);
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
 
-  // timeout if WiFi does not connect in WIFI_TIMEOUT ms from now
-  unsigned long timeout = millis() + WIFI_TIMEOUT;
-  wl_status_t connection_status = WiFi.status();
-
-  while ((connection_status != WL_CONNECTED) && (millis() < timeout)) {
-    Serial.print(".");
-    delay(50);
-    connection_status = WiFi.status();
+  // block until we get an IP address or WIFI_TIMEOUT ms pass, the CPU is free
+  // to light sleep in the meantime
+  setAutoLightSleep(true);
+  EventBits_t bits = xEventGroupWaitBits(
+      getNetEvents(), NET_WIFI_GOT_IP, pdFALSE, pdTRUE,
+      pdMS_TO_TICKS(budgetClampTimeout(WIFI_TIMEOUT)));
+  setAutoLightSleep(false);
+  if (!(bits & NET_WIFI_GOT_IP)) {
+    budgetAllows(1); // records the overrun if the budget cut the wait short
   }
-  Serial.println();
+  WiFi.removeEvent(eventId);
+  wl_status_t connection_status = WiFi.status();
 
   if (connection_status == WL_CONNECTED) {
     wifiRSSI = WiFi.RSSI(); // get WiFi signal strength now, because the WiFi
@@ -112,19 +147,22 @@ bool printLocalTime(tm *timeInfo) {
  * Note: Must be connected to WiFi to get time from NTP server.
  */
 bool waitForSNTPSync(tm *timeInfo) {
-  // Wait for SNTP synchronization to complete
-  unsigned long timeout = millis() + NTP_TIMEOUT;
-  if ((sntp_get_sync_status() == SNTP_SYNC_STATUS_RESET) &&
-      (millis() < timeout)) {
-    Serial.print(TXT_WAITING_FOR_SNTP);
-    delay(100); // ms
-    while ((sntp_get_sync_status() == SNTP_SYNC_STATUS_RESET) &&
-           (millis() < timeout)) {
-      Serial.print(".");
-      delay(100); // ms
+  // Wait for SNTP synchronization to complete. Register for the notification
+  // before checking the status so that a sync can not slip in between.
+  xEventGroupClearBits(getNetEvents(), NET_SNTP_SYNCED);
+  sntp_set_time_sync_notification_cb(onSNTPSync);
+  if (sntp_get_sync_status() == SNTP_SYNC_STATUS_RESET) {
+    Serial.println(TXT_WAITING_FOR_SNTP);
+    setAutoLightSleep(true);
+    EventBits_t bits = xEventGroupWaitBits(
+        getNetEvents(), NET_SNTP_SYNCED, pdTRUE, pdTRUE,
+        pdMS_TO_TICKS(budgetClampTimeout(NTP_TIMEOUT)));
+    setAutoLightSleep(false);
+    if (!(bits & NET_SNTP_SYNCED)) {
+      budgetAllows(1);
     }
-    Serial.println();
   }
+  sntp_set_time_sync_notification_cb(nullptr);
   return printLocalTime(timeInfo);
 } // waitForSNTPSync
 
@@ -155,7 +193,7 @@ int getDWDonecall(WiFiClientSecure &client, dwd_resp_onecall_t &r, tm &time_info
 
   Serial.println("***** " + OWM_ENDPOINT + ":" + OWM_PORT + uri);
 
-  int httpResponse = 0;
+  int httpResponse = HTTPC_ERROR_READ_TIMEOUT;
   while (!rxSuccess && attempts < 3) {
     wl_status_t connection_status = WiFi.status();
     if (connection_status != WL_CONNECTED) {
@@ -163,14 +201,24 @@ int getDWDonecall(WiFiClientSecure &client, dwd_resp_onecall_t &r, tm &time_info
       return -512 - static_cast<int>(connection_status);
     }
 
+    // Only retry if there is budget for a full attempt, a retry cut short by
+    // the budget would most likely fail the same way.
+    uint32_t minBudget = attempts == 0 ? 1000 : HTTP_CLIENT_TCP_TIMEOUT;
+    if (!budgetAllows(minBudget)) {
+      break;
+    }
+    uint32_t timeout = budgetClampTimeout(HTTP_CLIENT_TCP_TIMEOUT);
+
     HTTPClient http;
-    http.setConnectTimeout(HTTP_CLIENT_TCP_TIMEOUT); // default 5000ms
-    http.setTimeout(HTTP_CLIENT_TCP_TIMEOUT);        // default 5000ms
+    http.setConnectTimeout(timeout); // default 5000ms
+    http.setTimeout(timeout);        // default 5000ms
     http.begin(client, OWM_ENDPOINT, OWM_PORT, uri);
     httpResponse = http.GET();
     if (httpResponse == HTTP_CODE_OK) {
       Serial.println("start deserialization");
+      enterPhase(PHASE_PARSE);
       jsonErr = deserializeOneCall(http.getStream(), r, time_info);
+      enterPhase(PHASE_NETWORK);
       if (jsonErr) {
         // -256 offset distinguishes these errors from httpClient errors
         httpResponse = -256 - static_cast<int>(jsonErr.code());
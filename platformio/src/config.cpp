@@ -135,9 +135,54 @@ const int WAKE_TIME = 06; // Hour of first update after BED_TIME, 06:00.
 // setting both BED_TIME and WAKE_TIME to the hour you want it to update.
 
 // HOURLY OUTLOOK GRAPH
-// Number of hours to display on the outlook graph. (range: [8-48])
+// Number of hours to display on the outlook graph. (range: [8-96])
 const int HOURLY_GRAPH_MAX = 12;
 
+// CPU FREQUENCY
+// The CPU clock is switched for each phase of a wake. Parsing and rendering are
+// CPU-bound and use less energy overall when they finish sooner at a high
+// clock. Waiting on WiFi, sensors, or the e-paper panel gains nothing from a
+// fast clock. (valid: 240, 160, 80) WiFi requires at least 80MHz.
+const uint32_t CPU_FREQ_HIGH = 240; // MHz, parse and render
+const uint32_t CPU_FREQ_LOW  = 80;  // MHz, everything else
+
+// WAKE BUDGET
+// Limits how much time and charge a single wake may spend before the display
+// is updated. A slow access point or a stalled TLS handshake with retries can
+// otherwise keep the radio on for over a minute. Once the budget runs low,
+// timeouts are shortened and retries are skipped. If that means no new data
+// could be fetched, the display is left showing the previous forecast (its
+// status bar shows when it was last refreshed) instead of an error screen.
+// The phase that overran is saved to non-volatile storage for diagnostics.
+// Charge is estimated from typical currents for each phase, see
+// wake_budget.cpp.
+const uint32_t WAKE_TIME_BUDGET   = 45000; // ms
+const uint32_t WAKE_CHARGE_BUDGET = 3000;  // mAs (1mAh = 3600mAs)
+
+// PARTIAL REFRESH
+// Only the regions of the display that changed since the last refresh are
+// refreshed, with a partial refresh, which is quicker, uses less power and
+// does not flash the whole panel. Partial refreshes leave a faint ghost of
+// the previous image behind, so every FULL_REFRESH_INTERVAL-th refresh is a
+// full refresh, as is any refresh that changes more than FULL_REFRESH_AREA
+// percent of the display. Set FULL_REFRESH_INTERVAL to 1 to always do a full
+// refresh.
+const uint32_t FULL_REFRESH_INTERVAL = 12;
+const uint32_t FULL_REFRESH_AREA     = 50; // %
+
+// FAST REFRESH
+// Full refreshes use the panel's high temperature waveform, which takes about
+// 1.5s instead of 4s and flashes less, but leaves some ghosting behind. It
+// gives poor contrast on a cold panel, so it is not used while the indoor
+// temperature is below FAST_REFRESH_MIN_TEMP. Every CLEAN_REFRESH_INTERVAL-th
+// full refresh, and any that changes more than CLEAN_REFRESH_AREA percent of
+// the display, uses the normal waveform to clear the ghosting. Set
+// CLEAN_REFRESH_INTERVAL to 1 to never use the fast waveform. Only the 7.5in
+// (800x480) black and white panel supports this.
+const uint32_t CLEAN_REFRESH_INTERVAL = 6;
+const uint32_t CLEAN_REFRESH_AREA     = 80;   // %
+const float    FAST_REFRESH_MIN_TEMP  = 10.f; // Celsius
+
 // BATTERY
 // To protect the battery upon LOW_BATTERY_VOLTAGE, the display will cease to
 // update until battery is charged again. The ESP32 will deep-sleep (consuming
@@ -0,0 +1,760 @@
+/* Display list for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <Arduino.h>
+#include <GxEPD2.h>
+
+#include "display_list.h"
+
+const dl_pattern_t DL_PATTERN_CHECKER = {{0x80000000, 0x40000000}, 2, 2};
+const dl_pattern_t DL_PATTERN_HATCH = {
+    {0x80000000, 0x40000000, 0x20000000, 0x10000000}, 4, 4};
+const dl_pattern_t DL_PATTERN_DOTS = {{0x80000000, 0x00000000}, 2, 2};
+const dl_pattern_t DL_PATTERN_DOTTED_H = {{0x80000000}, 3, 1};
+const dl_pattern_t DL_PATTERN_DOTTED_V = {{0x80000000, 0, 0}, 1, 3};
+
+/* capacity is the number of draw calls to allocate room for up front.
+ */
+DisplayList::DisplayList(int16_t w, int16_t h, size_t capacity)
+    : Adafruit_GFX(w, h) {
+  _ops.reserve(capacity);
+}
+
+/* Same as Adafruit_GFX::getTextBounds(), but single lines of a font at text
+ * size 1 without wrapping, which is all the renderer prints, are measured from
+ * the glyph table alone and cached, see TextCache.
+ */
+void DisplayList::getTextBounds(const char *str, int16_t x, int16_t y,
+                                int16_t *x1, int16_t *y1, uint16_t *w,
+                                uint16_t *h) {
+  if (!gfxFont || textsize_x != 1 || textsize_y != 1 || wrap
+      || strchr(str, '\n')) {
+    Adafruit_GFX::getTextBounds(str, x, y, x1, y1, w, h);
+    return;
+  }
+  text_bounds_t b = _textCache.measure(gfxFont, str);
+  *x1 = x + b.x;
+  *y1 = y + b.y;
+  *w = b.w;
+  *h = b.h;
+  return;
+} // end getTextBounds
+
+void DisplayList::getTextBounds(const String &str, int16_t x, int16_t y,
+                                int16_t *x1, int16_t *y1, uint16_t *w,
+                                uint16_t *h) {
+  getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+  return;
+} // end getTextBounds
+
+/* Discards the recorded frame. The memory is kept for the next one.
+ */
+void DisplayList::clear() {
+  _ops.clear();
+  _volatile.clear();
+  return;
+} // end clear
+
+/* Marks a region of the frame as volatile, i.e. expected to change on every
+ * wake, like the time of the refresh. Volatile regions are ignored when
+ * deciding whether a frame is unchanged, see frameUnchanged().
+ */
+void DisplayList::markVolatile(int16_t x, int16_t y, int16_t w, int16_t h) {
+  _volatile.push_back({x, y, w, h});
+  return;
+} // end markVolatile
+
+/* Draws rows j0 to j1 (inclusive) of a w pixels wide bitmap, whose row j is
+ * drawn at (x, y + j), into raster, a byte at a time. Rows are byteWidth
+ * bytes each, and their set bits are drawn, or their clear bits if inverted.
+ *
+ * The icons are stored with 0 for the pixels to draw, and the frame with 0
+ * for black, so a black icon row is ANDed into the frame as it is, shifted
+ * into place when x is not a multiple of 8. Only the pixels to draw are
+ * touched, the rest of the frame shows through.
+ */
+static void blitRows(const dl_raster_t &raster, const uint8_t *rows,
+                     int16_t byteWidth, int16_t w, int16_t x, int16_t y,
+                     int16_t j0, int16_t j1, uint16_t color, bool inverted) {
+  int16_t stride = (raster.width + 7) / 8;
+  bool white = color == GxEPD_WHITE;
+  // x may be negative, it is split into a byte and a shift towards the right
+  int16_t xb = x >> 3;
+  int16_t shift = x & 7;
+  // the last frame byte may have padding bits, which are never drawn
+  uint8_t lastMask = raster.width % 8 ? 0xFF << (8 - raster.width % 8) : 0xFF;
+  // bits past the bitmap's width in its last byte are never drawn either
+  uint8_t tailMask = w % 8 ? 0xFF << (8 - w % 8) : 0xFF;
+  int16_t k1 = (w + 7) / 8;
+
+  auto apply = [&](uint8_t *row, int16_t i, uint8_t bits) {
+    if (i < 0 || i >= stride || bits == 0) {
+      return;
+    }
+    if (i == stride - 1) {
+      bits &= lastMask;
+    }
+    if (white) {
+      row[i] |= bits;
+    } else {
+      row[i] &= ~bits;
+    }
+  };
+
+  for (int16_t j = j0; j <= j1; ++j) {
+    const uint8_t *src = rows + j * byteWidth;
+    uint8_t *row = raster.buffer + (y + j - raster.top) * stride;
+    for (int16_t k = 0; k < k1; ++k) {
+      // 1 for every pixel to draw
+      uint8_t bits = pgm_read_byte(&src[k]);
+      if (inverted) {
+        bits = ~bits;
+      }
+      if (k == k1 - 1) {
+        bits &= tailMask;
+      }
+      apply(row, xb + k, bits >> shift);
+      if (shift) {
+        apply(row, xb + k + 1, bits << (8 - shift));
+      }
+    }
+  }
+  return;
+} // end blitRows
+
+/* Returns v modulo n, in 0 to n - 1 also for negative v.
+ */
+static int16_t phaseOf(int16_t v, int16_t n) {
+  int16_t r = v % n;
+  return r < 0 ? r + n : r;
+} // end phaseOf
+
+/* Returns row r of pattern repeated along 64 bits from its first pixel on, so
+ * that the 32 pixels starting at any phase of the pattern are a shift away.
+ */
+static uint64_t patternRow(const dl_pattern_t &pattern, int16_t r) {
+  uint32_t bits = pattern.bits[r];
+  if (pattern.period < 32) {
+    bits &= ~(0xFFFFFFFFu >> pattern.period);
+  }
+  uint64_t row = static_cast<uint64_t>(bits) << 32;
+  for (int16_t len = pattern.period; len < 64; len *= 2) {
+    row |= row >> len;
+  }
+  return row;
+} // end patternRow
+
+/* Draws the pixels set in mask, 32 pixels starting at byte i of a frame row,
+ * with one load and store. Bytes past the end of the row are left alone.
+ */
+static void drawWord(uint8_t *row, int16_t i, int16_t stride, uint32_t mask,
+                     bool white) {
+  if (i + 4 > stride) {
+    for (int16_t k = 0; i + k < stride; ++k) {
+      uint8_t bits = mask >> (24 - 8 * k);
+      row[i + k] = white ? row[i + k] | bits : row[i + k] & ~bits;
+    }
+    return;
+  }
+  uint32_t word;
+  memcpy(&word, row + i, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  // the first pixel is the most significant bit of the first byte
+  mask = __builtin_bswap32(mask);
+#endif
+  word = white ? word | mask : word & ~mask;
+  memcpy(row + i, &word, sizeof(word));
+  return;
+} // end drawWord
+
+/* Draws rows j0 to j1 (frame rows, inclusive) of a pattern op into raster,
+ * 32 pixels at a time. The op is clipped to the frame when recorded.
+ */
+static void blitPattern(const dl_raster_t &raster, const dl_op_t &op,
+                        int16_t j0, int16_t j1) {
+  const dl_pattern_t &pattern = *static_cast<const dl_pattern_t *>(op.data);
+  int16_t stride = (raster.width + 7) / 8;
+  bool white = op.color == GxEPD_WHITE;
+  int16_t x0 = op.x0;
+  int16_t x1 = std::min<int16_t>(op.x0 + op.x1, raster.width) - 1;
+  // words start every 32 pixels of the frame, and the pattern moves on by
+  // the same step from one word to the next
+  int16_t first = x0 & ~31;
+  int16_t phase0 = phaseOf(first - op.y0, pattern.period);
+  int16_t step = 32 % pattern.period;
+
+  for (int16_t y = j0; y <= j1; ++y) {
+    uint64_t bits = patternRow(pattern, phaseOf(y - op.y1, pattern.rows));
+    if (bits == 0) {
+      continue;
+    }
+    uint8_t *row = raster.buffer + (y - raster.top) * stride;
+    int16_t phase = phase0;
+    for (int16_t x = first; x <= x1; x += 32) {
+      uint32_t mask = static_cast<uint32_t>((bits << phase) >> 32);
+      if (x < x0) {
+        mask &= 0xFFFFFFFFu >> (x0 - x);
+      }
+      if (x + 31 > x1) {
+        mask &= ~(0xFFFFFFFFu >> (x1 - x + 1));
+      }
+      drawWord(row, x / 8, stride, mask, white);
+      phase += step;
+      if (phase >= pattern.period) {
+        phase -= pattern.period;
+      }
+    }
+  }
+  return;
+} // end blitPattern
+
+/* Draws the rows top to bottom (inclusive) of a glyph op at text size 1 into
+ * raster, from the glyph cache. Returns false if the glyph is not cached.
+ */
+bool DisplayList::blitGlyph(const dl_raster_t &raster, const dl_op_t &op,
+                            int16_t top, int16_t bottom) const {
+  const GFXfont *font = static_cast<const GFXfont *>(op.data);
+  uint8_t c = static_cast<uint8_t>(op.y1);
+  const uint8_t *rows = _glyphs.rows(font, c);
+  if (rows == nullptr) {
+    return false;
+  }
+  const GFXglyph *glyph = &font->glyph[c - pgm_read_byte(&font->first)];
+  int16_t w = pgm_read_byte(&glyph->width);
+  int16_t x = op.x0 + static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+  // op.top is the glyph's first row
+  int16_t j0 = std::max({top, op.top, raster.top}) - op.top;
+  int16_t j1 = std::min({bottom, op.bottom,
+                         static_cast<int16_t>(raster.top + raster.rows - 1)})
+               - op.top;
+  blitRows(raster, rows, (w + 7) / 8, w, x, op.top, j0, j1, op.color, false);
+  return true;
+} // end blitGlyph
+
+/* Rasterizes every recorded draw call that touches rows top to bottom
+ * (inclusive) into target, in the order they were recorded. Coordinates are
+ * not rotated, so target is expected to use the same rotation as this list.
+ *
+ * If target is backed by raster, bitmaps, glyphs and patterns are blitted
+ * into it directly.
+ */
+void DisplayList::replay(Adafruit_GFX &target, int16_t top, int16_t bottom,
+                         const dl_raster_t *raster) const {
+  for (const dl_op_t &op : _ops) {
+    if (op.bottom < top || op.top > bottom) {
+      continue;
+    }
+    switch (op.type) {
+    case DL_GLYPH:
+      if (raster && op.data && op.x1 == 0x0101
+          && blitGlyph(*raster, op, top, bottom)) {
+        break;
+      }
+      target.setFont(static_cast<const GFXfont *>(op.data));
+      target.drawChar(op.x0, op.y0, static_cast<unsigned char>(op.y1),
+                      op.color, op.color, op.x1 & 0xFF, op.x1 >> 8);
+      break;
+    case DL_LINE:
+      target.drawLine(op.x0, op.y0, op.x1, op.y1, op.color);
+      break;
+    case DL_FILL_RECT: {
+      int16_t y0 = std::max(op.top, top);
+      int16_t y1 = std::min(op.bottom, bottom);
+      target.fillRect(op.x0, y0, op.x1, y1 - y0 + 1, op.color);
+      break;
+    }
+    case DL_PIXELS:
+      for (int16_t i = 0; i < op.x1; ++i) {
+        target.drawPixel(op.x0 + i * op.y1, op.y0, op.color);
+      }
+      break;
+    case DL_PATTERN: {
+      int16_t j0 = std::max(top, op.top);
+      int16_t j1 = std::min(bottom, op.bottom);
+      if (raster) {
+        j0 = std::max(j0, raster->top);
+        j1 = std::min<int16_t>(j1, raster->top + raster->rows - 1);
+        blitPattern(*raster, op, j0, j1);
+        break;
+      }
+      const dl_pattern_t &pattern =
+          *static_cast<const dl_pattern_t *>(op.data);
+      for (int16_t y = j0; y <= j1; ++y) {
+        uint64_t bits = patternRow(pattern, phaseOf(y - op.y1, pattern.rows));
+        for (int16_t x = op.x0; bits && x < op.x0 + op.x1; ++x) {
+          if ((bits << phaseOf(x - op.y0, pattern.period)) >> 63) {
+            target.drawPixel(x, y, op.color);
+          }
+        }
+      }
+      break;
+    }
+    case DL_INVERTED_BITMAP: {
+      // bits that are 0 are drawn, like GxEPD2
+      const uint8_t *bitmap = static_cast<const uint8_t *>(op.data);
+      int16_t byteWidth = (op.x1 + 7) / 8;
+      int16_t j0 = std::max(top, op.top) - op.y0;
+      int16_t j1 = std::min(bottom, op.bottom) - op.y0;
+      if (raster) {
+        j0 = std::max<int16_t>(j0, raster->top - op.y0);
+        j1 = std::min<int16_t>(j1, raster->top + raster->rows - 1 - op.y0);
+        blitRows(*raster, bitmap, byteWidth, op.x1, op.x0, op.y0, j0, j1,
+                 op.color, true);
+        break;
+      }
+      for (int16_t j = j0; j <= j1; ++j) {
+        const uint8_t *row = bitmap + j * byteWidth;
+        uint8_t byte = 0;
+        for (int16_t i = 0; i < op.x1; ++i) {
+          if (i & 7) {
+            byte <<= 1;
+          } else {
+            byte = pgm_read_byte(&row[i / 8]);
+          }
+          if (!(byte & 0x80)) {
+            target.drawPixel(op.x0 + i, op.y0 + j, op.color);
+          }
+        }
+      }
+      break;
+    }
+    }
+  }
+  return;
+} // end replay
+
+/* Returns the box an op draws into. It is exact for bitmaps, see inkBounds().
+ */
+static dl_rect_t opBox(const dl_op_t &op) {
+  int16_t x0 = op.x0;
+  int16_t x1 = op.x0 + 1;
+  switch (op.type) {
+  case DL_GLYPH: {
+    int16_t sx = op.x1 & 0xFF;
+    const GFXfont *font = static_cast<const GFXfont *>(op.data);
+    if (font == nullptr) {
+      x1 = op.x0 + 6 * sx;
+      break;
+    }
+    const GFXglyph *glyph =
+        &font->glyph[(op.y1 & 0xFF) - pgm_read_byte(&font->first)];
+    x0 = op.x0 + static_cast<int8_t>(pgm_read_byte(&glyph->xOffset)) * sx;
+    x1 = x0 + pgm_read_byte(&glyph->width) * sx;
+    break;
+  }
+  case DL_LINE:
+    x0 = std::min(op.x0, op.x1);
+    x1 = std::max(op.x0, op.x1) + 1;
+    break;
+  case DL_FILL_RECT:
+  case DL_PATTERN:
+  case DL_INVERTED_BITMAP:
+    x1 = op.x0 + op.x1;
+    break;
+  case DL_PIXELS:
+    x1 = op.x0 + (op.x1 - 1) * op.y1 + 1;
+    break;
+  }
+  return {x0, op.top, static_cast<int16_t>(x1 - x0),
+          static_cast<int16_t>(op.bottom - op.top + 1)};
+} // end opBox
+
+/* Returns the bounding box of the pixels that the calls first to last
+ * (exclusive) draw into clip, or an empty box (w = 0) if they draw none there.
+ * Bitmaps are bounded by the pixels they draw, everything else by the box it
+ * draws into.
+ */
+dl_rect_t DisplayList::inkBounds(size_t first, size_t last,
+                                 const dl_rect_t &clip) const {
+  int16_t bx0 = INT16_MAX, by0 = INT16_MAX, bx1 = INT16_MIN, by1 = INT16_MIN;
+  for (size_t n = first; n < last && n < _ops.size(); ++n) {
+    const dl_op_t &op = _ops[n];
+    dl_rect_t box = opBox(op);
+    int16_t x0 = std::max(box.x, clip.x);
+    int16_t y0 = std::max(box.y, clip.y);
+    int16_t x1 = std::min<int16_t>(box.x + box.w, clip.x + clip.w);
+    int16_t y1 = std::min<int16_t>(box.y + box.h, clip.y + clip.h);
+    if (x0 >= x1 || y0 >= y1) {
+      continue;
+    }
+    if (op.type == DL_INVERTED_BITMAP) {
+      // bits that are 0 are drawn
+      const uint8_t *bitmap = static_cast<const uint8_t *>(op.data);
+      int16_t byteWidth = (op.x1 + 7) / 8;
+      int16_t ix0 = INT16_MAX, iy0 = INT16_MAX, ix1 = INT16_MIN,
+              iy1 = INT16_MIN;
+      for (int16_t y = y0; y < y1; ++y) {
+        const uint8_t *row = bitmap + (y - op.y0) * byteWidth;
+        for (int16_t x = x0; x < x1; ++x) {
+          int16_t i = x - op.x0;
+          if (!(pgm_read_byte(&row[i / 8]) & (0x80 >> (i & 7)))) {
+            ix0 = std::min(ix0, x);
+            ix1 = std::max<int16_t>(ix1, x + 1);
+            iy0 = std::min(iy0, y);
+            iy1 = std::max<int16_t>(iy1, y + 1);
+          }
+        }
+      }
+      if (ix0 >= ix1) {
+        continue;
+      }
+      x0 = ix0;
+      x1 = ix1;
+      y0 = iy0;
+      y1 = iy1;
+    }
+    bx0 = std::min(bx0, x0);
+    by0 = std::min(by0, y0);
+    bx1 = std::max(bx1, x1);
+    by1 = std::max(by1, y1);
+  }
+  if (bx0 >= bx1) {
+    return {0, 0, 0, 0};
+  }
+  return {bx0, by0, static_cast<int16_t>(bx1 - bx0),
+          static_cast<int16_t>(by1 - by0)};
+} // end inkBounds
+
+/* Records a pixel. A pixel continuing an evenly spaced run along the same row,
+ * as drawn by dotted lines and fill patterns, extends the previous call.
+ */
+void DisplayList::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || x >= _width || y < 0 || y >= _height) {
+    return;
+  }
+  if (!_ops.empty()) {
+    dl_op_t &last = _ops.back();
+    if (last.type == DL_PIXELS && last.y0 == y && last.color == color
+        && last.x1 < INT16_MAX) {
+      int dx = x - last.x0;
+      if (last.x1 == 1 && dx > 0) {
+        last.y1 = dx;
+        ++last.x1;
+        return;
+      }
+      if (last.x1 > 1 && dx == last.x1 * last.y1) {
+        ++last.x1;
+        return;
+      }
+    }
+  }
+  _ops.push_back({nullptr, y, y, x, y, 1, 1, color, DL_PIXELS});
+  return;
+} // end drawPixel
+
+void DisplayList::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                uint16_t color) {
+  if (h <= 0) {
+    drawLine(x, y, x, y + h - 1, color);
+    return;
+  }
+  fillRect(x, y, 1, h, color);
+  return;
+} // end drawFastVLine
+
+void DisplayList::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                uint16_t color) {
+  if (w <= 0) {
+    drawLine(x, y, x + w - 1, y, color);
+    return;
+  }
+  fillRect(x, y, w, 1, color);
+  return;
+} // end drawFastHLine
+
+void DisplayList::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                           uint16_t color) {
+  if (w <= 0 || h <= 0 || x >= _width || y >= _height || x + w <= 0
+      || y + h <= 0) {
+    return;
+  }
+  _ops.push_back({nullptr, y, static_cast<int16_t>(y + h - 1), x, y, w, h,
+                  color, DL_FILL_RECT});
+  return;
+} // end fillRect
+
+void DisplayList::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                           uint16_t color) {
+  int16_t top = std::min(y0, y1);
+  int16_t bottom = std::max(y0, y1);
+  if (bottom < 0 || top >= _height) {
+    return;
+  }
+  _ops.push_back({nullptr, top, bottom, x0, y0, x1, y1, color, DL_LINE});
+  return;
+} // end drawLine
+
+/* Records a bitmap, drawn by GxEPD2's drawInvertedBitmap. The bitmap must
+ * outlive the recorded frame, which holds for the icons in flash.
+ */
+void DisplayList::drawInvertedBitmap(int16_t x, int16_t y,
+                                     const uint8_t bitmap[], int16_t w,
+                                     int16_t h, uint16_t color, bool pgm) {
+  if (w <= 0 || h <= 0 || y >= _height || y + h <= 0) {
+    return;
+  }
+  _ops.push_back({bitmap, y, static_cast<int16_t>(y + h - 1), x, y, w, h,
+                  color, DL_INVERTED_BITMAP});
+  return;
+} // end drawInvertedBitmap
+
+// Longest a miter join may reach past its vertex, in stroke half widths,
+// sharper joins are beveled instead
+#define DL_MITER_LIMIT 2.0f
+
+typedef struct dl_span {
+  int16_t y;
+  int16_t x0;
+  int16_t x1; // exclusive
+} dl_span_t;
+
+/* Adds the pixels, with their centers inside the convex polygon px, py, to
+ * spans, one span per row. Pixel (i, j) has its center at (i + 0.5, j + 0.5).
+ */
+static void addPolygon(std::vector<dl_span_t> &spans, const float *px,
+                       const float *py, int n, int16_t height) {
+  float minY = *std::min_element(py, py + n);
+  float maxY = *std::max_element(py, py + n);
+  int16_t j0 = std::max<int16_t>(std::ceil(minY - 0.5f), 0);
+  int16_t j1 = std::min<int16_t>(std::ceil(maxY - 0.5f), height);
+  for (int16_t j = j0; j < j1; ++j) {
+    float yc = j + 0.5f;
+    float xl = INFINITY;
+    float xr = -INFINITY;
+    for (int k = 0; k < n; ++k) {
+      float ax = px[k], ay = py[k];
+      float bx = px[(k + 1) % n], by = py[(k + 1) % n];
+      if (yc < std::min(ay, by) || yc > std::max(ay, by)) {
+        continue;
+      }
+      float x = ay == by ? ax : ax + (yc - ay) * (bx - ax) / (by - ay);
+      xl = std::min({xl, x, ay == by ? bx : x});
+      xr = std::max({xr, x, ay == by ? bx : x});
+    }
+    int16_t i0 = std::ceil(xl - 0.5f);
+    int16_t i1 = std::ceil(xr - 0.5f);
+    if (i0 < i1) {
+      spans.push_back({j, i0, i1});
+    }
+  }
+  return;
+} // end addPolygon
+
+/* Adds the pixels with their centers inside a disc to spans.
+ */
+static void addDisc(std::vector<dl_span_t> &spans, float cx, float cy,
+                    float r, int16_t height) {
+  int16_t j0 = std::max<int16_t>(std::ceil(cy - r - 0.5f), 0);
+  int16_t j1 = std::min<int16_t>(std::ceil(cy + r - 0.5f), height);
+  for (int16_t j = j0; j < j1; ++j) {
+    float dy = j + 0.5f - cy;
+    float half = std::sqrt(std::max(r * r - dy * dy, 0.0f));
+    int16_t i0 = std::ceil(cx - half - 0.5f);
+    int16_t i1 = std::ceil(cx + half - 0.5f);
+    if (i0 < i1) {
+      spans.push_back({j, i0, i1});
+    }
+  }
+  return;
+} // end addDisc
+
+/* Records a polyline through the n points x, y, width pixels wide.
+ *
+ * The stroke is made of a rectangle per segment and a join per vertex, which
+ * are all rasterized into spans along rows first. The spans are then merged,
+ * so that each row of the line is recorded once, as filled runs.
+ */
+void DisplayList::drawPolyline(const int16_t *x, const int16_t *y, size_t n,
+                               uint8_t width, dl_join_t join,
+                               uint16_t color) {
+  if (n == 0 || width == 0) {
+    return;
+  }
+  // pixel centers, without repeated points
+  std::vector<float> px, py;
+  px.reserve(n);
+  py.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    if (i == 0 || x[i] != x[i - 1] || y[i] != y[i - 1]) {
+      px.push_back(x[i] + 0.5f);
+      py.push_back(y[i] + 0.5f);
+    }
+  }
+  size_t m = px.size();
+  float h = width / 2.0f;
+  std::vector<dl_span_t> spans;
+
+  // unit normal of segment i
+  auto normal = [&](size_t i, float &nx, float &ny) {
+    float dx = px[i + 1] - px[i];
+    float dy = py[i + 1] - py[i];
+    float len = std::sqrt(dx * dx + dy * dy);
+    nx = -dy / len;
+    ny = dx / len;
+  };
+
+  for (size_t i = 0; i + 1 < m; ++i) {
+    float nx, ny;
+    normal(i, nx, ny);
+    float qx[] = {px[i] + nx * h, px[i + 1] + nx * h, px[i + 1] - nx * h,
+                  px[i] - nx * h};
+    float qy[] = {py[i] + ny * h, py[i + 1] + ny * h, py[i + 1] - ny * h,
+                  py[i] - ny * h};
+    addPolygon(spans, qx, qy, 4, _height);
+  }
+
+  if (join == DL_JOIN_ROUND) {
+    for (size_t i = 0; i < m; ++i) {
+      addDisc(spans, px[i], py[i], h, _height);
+    }
+  } else {
+    for (size_t i = 1; i + 1 < m; ++i) {
+      float n0x, n0y, n1x, n1y;
+      normal(i - 1, n0x, n0y);
+      normal(i, n1x, n1y);
+      // the segments turn towards the side of their normals if positive
+      float turn = n0x * (px[i + 1] - px[i]) + n0y * (py[i + 1] - py[i]);
+      if (std::fabs(turn) < 1e-3f) {
+        continue;
+      }
+      float s = turn > 0 ? -h : h;
+      // outer corners of both segments, and the miter tip between them
+      float ax = px[i] + n0x * s, ay = py[i] + n0y * s;
+      float bx = px[i] + n1x * s, by = py[i] + n1y * s;
+      float mx = n0x + n1x, my = n0y + n1y;
+      float len = std::sqrt(mx * mx + my * my);
+      float cosHalf = len / 2; // between the miter and either normal
+      if (cosHalf * DL_MITER_LIMIT >= 1) {
+        float tip = s / (cosHalf * len);
+        float qx[] = {px[i], ax, px[i] + mx * tip, bx};
+        float qy[] = {py[i], ay, py[i] + my * tip, by};
+        addPolygon(spans, qx, qy, 4, _height);
+      } else {
+        float qx[] = {px[i], ax, bx};
+        float qy[] = {py[i], ay, by};
+        addPolygon(spans, qx, qy, 3, _height);
+      }
+    }
+    if (m == 1) {
+      float qx[] = {px[0] - h, px[0] + h, px[0] + h, px[0] - h};
+      float qy[] = {py[0] - h, py[0] - h, py[0] + h, py[0] + h};
+      addPolygon(spans, qx, qy, 4, _height);
+    }
+  }
+
+  std::sort(spans.begin(), spans.end(),
+            [](const dl_span_t &a, const dl_span_t &b) {
+              return a.y != b.y ? a.y < b.y : a.x0 < b.x0;
+            });
+  for (size_t i = 0; i < spans.size();) {
+    dl_span_t run = spans[i];
+    for (++i; i < spans.size() && spans[i].y == run.y
+              && spans[i].x0 <= run.x1;
+         ++i) {
+      run.x1 = std::max(run.x1, spans[i].x1);
+    }
+    fillRect(run.x0, run.y, run.x1 - run.x0, 1, color);
+  }
+  return;
+} // end drawPolyline
+
+/* Records a rectangle filled with pattern, which must outlive the recorded
+ * frame. The pattern is aligned to originX, originY, so that fills next to
+ * each other with the same origin continue the same pattern.
+ */
+void DisplayList::fillPattern(int16_t x, int16_t y, int16_t w, int16_t h,
+                              const dl_pattern_t &pattern, uint16_t color,
+                              int16_t originX, int16_t originY) {
+  int16_t x0 = std::max<int16_t>(x, 0);
+  int16_t x1 = std::min<int16_t>(x + w, _width);
+  int16_t y0 = std::max<int16_t>(y, 0);
+  int16_t y1 = std::min<int16_t>(y + h, _height);
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+  _ops.push_back({&pattern, y0, static_cast<int16_t>(y1 - 1), x0, originX,
+                  static_cast<int16_t>(x1 - x0), originY, color, DL_PATTERN});
+  return;
+} // end fillPattern
+
+/* Same cursor handling as Adafruit_GFX::write, but each character is recorded
+ * as one call instead of being drawn pixel by pixel.
+ */
+size_t DisplayList::write(uint8_t c) {
+  if (!gfxFont) {
+    if (c == '\n') {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    } else if (c != '\r') {
+      if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+      }
+      addGlyph(c);
+      cursor_x += textsize_x * 6;
+    }
+    return 1;
+  }
+
+  uint8_t yAdvance = pgm_read_byte(&gfxFont->yAdvance);
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += static_cast<int16_t>(textsize_y) * yAdvance;
+  } else if (c != '\r') {
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    if (c >= first && c <= static_cast<uint8_t>(pgm_read_byte(&gfxFont->last))) {
+      const GFXglyph *glyph = &gfxFont->glyph[c - first];
+      uint8_t w = pgm_read_byte(&glyph->width);
+      uint8_t h = pgm_read_byte(&glyph->height);
+      if (w > 0 && h > 0) {
+        int16_t xo = static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+        if (wrap && ((cursor_x + textsize_x * (xo + w)) > _width)) {
+          cursor_x = 0;
+          cursor_y += static_cast<int16_t>(textsize_y) * yAdvance;
+        }
+        addGlyph(c);
+      }
+      cursor_x +=
+          pgm_read_byte(&glyph->xAdvance) * static_cast<int16_t>(textsize_x);
+    }
+  }
+  return 1;
+} // end write
+
+/* Records character c at the cursor in the current font, size and color.
+ */
+void DisplayList::addGlyph(unsigned char c) {
+  int16_t top = cursor_y;
+  int16_t bottom = cursor_y + textsize_y * 8 - 1;
+  if (gfxFont) {
+    const GFXglyph *glyph =
+        &gfxFont->glyph[c - pgm_read_byte(&gfxFont->first)];
+    int8_t yo = static_cast<int8_t>(pgm_read_byte(&glyph->yOffset));
+    top = cursor_y + yo * textsize_y;
+    bottom = top + pgm_read_byte(&glyph->height) * textsize_y - 1;
+  }
+  if (bottom < 0 || top >= _height) {
+    return;
+  }
+  _ops.push_back({gfxFont, top, bottom, cursor_x, cursor_y,
+                  static_cast<int16_t>(textsize_x | (textsize_y << 8)), c,
+                  textcolor, DL_GLYPH});
+  return;
+} // end addGlyph
@@ -0,0 +1,35 @@
+/* Fast refresh e-paper driver for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "epd_fast_refresh.h"
+
+/* Full refreshes use the fast waveform if enabled by setFastFullRefresh().
+ */
+void GxEPD2_750_T7_Fast::refresh(bool partial_update_mode) {
+  if (!partial_update_mode) {
+    // cascade setting, TSFIX: use the temperature forced with 0xE5 instead
+    // of the measured one
+    _writeCommand(0xE0);
+    _writeData(_fast ? 0x02 : 0x00);
+    if (_fast) {
+      _writeCommand(0xE5);
+      _writeData(0x5A); // 90C
+    }
+  }
+  GxEPD2_750_T7::refresh(partial_update_mode);
+  return;
+} // end refresh
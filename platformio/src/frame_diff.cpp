@@ -0,0 +1,519 @@
+/* Frame diff for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <Arduino.h>
+#include <GxEPD2.h>
+#include <esp_attr.h>
+#include <esp_partition.h>
+
+#include "frame_diff.h"
+
+static_assert(FRAME_TILE_W == 32, "a tile is one 32-bit word of a row");
+
+typedef enum frame_store : uint8_t
+{
+  FRAME_NONE,
+  FRAME_RTC,
+  FRAME_FLASH
+} frame_store_t;
+
+// The frame on the panel, each row PackBits encoded. It is kept in RTC memory
+// or, if too large, in a slot of the data partition that moves on with every
+// save so that erase cycles are spread over the partition. RTC memory is
+// cleared on power-on and reset, so the panel is always fully refreshed then.
+static RTC_DATA_ATTR uint8_t frameRtc[FRAME_RTC_BYTES];
+static RTC_DATA_ATTR frame_store_t frameStore;
+static RTC_DATA_ATTR uint32_t frameBytes;
+static RTC_DATA_ATTR uint32_t frameSlot;
+static RTC_DATA_ATTR int16_t frameWidth;
+static RTC_DATA_ATTR int16_t frameHeight;
+static RTC_DATA_ATTR uint32_t partialRefreshes;
+// hash of the frame on the panel without its volatile regions, kept even if
+// the frame itself was too large to store
+static RTC_DATA_ATTR uint32_t frameHash;
+static RTC_DATA_ATTR bool frameHashValid;
+
+// the frame compared by the last frameDiff(), stored by frameSave()
+static std::vector<uint8_t> nextFrame;
+static int16_t nextWidth;
+static int16_t nextHeight;
+static uint32_t nextHash;
+
+FrameBand::FrameBand(int16_t w, int16_t h, int16_t rows)
+    : Adafruit_GFX(w, h), _top(0), _rows(rows),
+      _buffer((w + 7) / 8 * rows, 0xFF) {}
+
+void FrameBand::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  y -= _top;
+  if (x < 0 || x >= _width || y < 0 || y >= _rows) {
+    return;
+  }
+  uint8_t &b = _buffer[x / 8 + y * ((_width + 7) / 8)];
+  if (color == GxEPD_WHITE) {
+    b |= 0x80 >> (x % 8);
+  } else {
+    b &= ~(0x80 >> (x % 8));
+  }
+  return;
+} // end drawPixel
+
+void FrameBand::fillScreen(uint16_t color) {
+  std::fill(_buffer.begin(), _buffer.end(), color == GxEPD_WHITE ? 0xFF : 0x00);
+  return;
+} // end fillScreen
+
+/* Draws the rows of list that are in the band, with bitmaps blitted straight
+ * into the band's buffer.
+ */
+void FrameBand::replay(const DisplayList &list) {
+  dl_raster_t raster = {_buffer.data(), _width, _top, _rows};
+  list.replay(*this, _top, _top + _rows - 1, &raster);
+  return;
+} // end replay
+
+static const esp_partition_t *dataPartition() {
+  return esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                  ESP_PARTITION_SUBTYPE_DATA_SPIFFS, nullptr);
+} // end dataPartition
+
+/* Read access to the stored frame, which is memory mapped while in flash.
+ */
+class StoredFrame {
+public:
+  StoredFrame() : _data(nullptr), _mapped(false) {
+    if (frameStore == FRAME_RTC) {
+      _data = frameRtc;
+    } else if (frameStore == FRAME_FLASH) {
+      const esp_partition_t *partition = dataPartition();
+      const void *p;
+      if (partition != nullptr
+          && esp_partition_mmap(partition, frameSlot * FRAME_FLASH_SLOT,
+                                frameBytes, ESP_PARTITION_MMAP_DATA, &p,
+                                &_handle) == ESP_OK) {
+        _data = static_cast<const uint8_t *>(p);
+        _mapped = true;
+      }
+    }
+  }
+  ~StoredFrame() {
+    if (_mapped) {
+      spi_flash_munmap(_handle);
+    }
+  }
+  const uint8_t *begin() const { return _data; }
+  const uint8_t *end() const { return _data ? _data + frameBytes : nullptr; }
+
+private:
+  const uint8_t *_data;
+  bool _mapped;
+  spi_flash_mmap_handle_t _handle;
+};
+
+/* Appends n bytes of a row to out, PackBits encoded. Runs of 2 or more equal
+ * bytes become a count and the byte, anything else is copied literally.
+ */
+static void packRow(const uint8_t *src, size_t n, std::vector<uint8_t> &out) {
+  size_t i = 0;
+  while (i < n) {
+    size_t run = 1;
+    while (i + run < n && run < 128 && src[i + run] == src[i]) {
+      ++run;
+    }
+    if (run > 1) {
+      out.push_back(static_cast<uint8_t>(1 - static_cast<int>(run)));
+      out.push_back(src[i]);
+      i += run;
+      continue;
+    }
+    size_t literal = 1;
+    while (i + literal < n && literal < 128
+           && !(i + literal + 1 < n
+                && src[i + literal] == src[i + literal + 1])) {
+      ++literal;
+    }
+    out.push_back(static_cast<uint8_t>(literal - 1));
+    out.insert(out.end(), src + i, src + i + literal);
+    i += literal;
+  }
+  return;
+} // end packRow
+
+/* Decodes a row of n bytes, written by packRow, into dst. Returns where the
+ * next row starts, or nullptr if the data is corrupt.
+ */
+static const uint8_t *unpackRow(const uint8_t *src, const uint8_t *end,
+                                uint8_t *dst, size_t n) {
+  size_t i = 0;
+  while (i < n) {
+    if (src >= end) {
+      return nullptr;
+    }
+    int8_t header = static_cast<int8_t>(*src++);
+    if (header >= 0) {
+      size_t count = header + 1;
+      if (count > n - i || count > static_cast<size_t>(end - src)) {
+        return nullptr;
+      }
+      memcpy(dst + i, src, count);
+      src += count;
+      i += count;
+    } else if (header != -128) {
+      size_t count = 1 - header;
+      if (count > n - i || src >= end) {
+        return nullptr;
+      }
+      memset(dst + i, *src++, count);
+      i += count;
+    }
+  }
+  return src;
+} // end unpackRow
+
+/* Rasterizes list bandRows at a time and calls fn(y, row) for every row, in
+ * order, with the row's (width + 7) / 8 bytes.
+ */
+template <typename Fn>
+static void forEachRow(const DisplayList &list, int16_t bandRows, Fn fn) {
+  int16_t w = list.width();
+  int16_t h = list.height();
+  size_t rowBytes = (w + 7) / 8;
+  std::unique_ptr<FrameBand> band(new FrameBand(w, h, bandRows));
+  for (int16_t top = 0; top < h; top += bandRows) {
+    band->setTop(top);
+    band->fillScreen(GxEPD_WHITE);
+    band->replay(list);
+    for (int16_t y = top; y < std::min<int16_t>(h, top + bandRows); ++y) {
+      fn(y, band->buffer() + (y - top) * rowBytes);
+    }
+  }
+  return;
+} // end forEachRow
+
+/* 32-bit FNV-1a hash of a frame, a word at a time, with the pixels in the
+ * list's volatile regions hashed as white. Their positions are left out, as
+ * a volatile string that changes width moves everything next to it.
+ */
+class FrameHash {
+public:
+  explicit FrameHash(const DisplayList &list)
+      : _hash(2166136261u), _width(list.width()),
+        _volatile(list.volatileRects()) {}
+  /* Adds a row of words. The row is modified, volatile pixels are set to
+   * white.
+   */
+  void addRow(int16_t y, uint32_t *row, size_t words) {
+    uint8_t *bytes = reinterpret_cast<uint8_t *>(row);
+    for (const dl_rect_t &r : _volatile) {
+      if (y < r.y || y >= r.y + r.h) {
+        continue;
+      }
+      int16_t x0 = std::max<int16_t>(r.x, 0);
+      int16_t x1 = std::min<int16_t>(r.x + r.w, _width);
+      for (int16_t x = x0; x < x1; ++x) {
+        bytes[x / 8] |= 0x80 >> (x % 8);
+      }
+    }
+    for (size_t i = 0; i < words; ++i) {
+      add(row[i]);
+    }
+    return;
+  }
+  uint32_t value() const { return _hash; }
+
+private:
+  void add(uint32_t word) { _hash = (_hash ^ word) * 16777619u; }
+
+  uint32_t _hash;
+  int16_t _width;
+  const std::vector<dl_rect_t> &_volatile;
+};
+
+/* Merges the changed tiles into at most maxRects rectangles, in tiles.
+ *
+ * Each run of changed tiles along a tile row becomes a rectangle, which grows
+ * downwards while the rows below have a run with the same span. Then the two
+ * rectangles whose bounding box adds the least unchanged area are merged,
+ * until few enough remain.
+ */
+static void coalesce(const std::vector<uint8_t> &dirty, int16_t cols,
+                     int16_t rows, size_t maxRects,
+                     std::vector<frame_rect_t> &rects) {
+  rects.clear();
+  std::vector<size_t> above;
+  for (int16_t r = 0; r < rows; ++r) {
+    std::vector<size_t> current;
+    int16_t c = 0;
+    while (c < cols) {
+      if (!dirty[r * cols + c]) {
+        ++c;
+        continue;
+      }
+      int16_t c0 = c;
+      while (c < cols && dirty[r * cols + c]) {
+        ++c;
+      }
+      auto it = std::find_if(above.begin(), above.end(), [&](size_t i) {
+        return rects[i].x == c0 && rects[i].w == c - c0;
+      });
+      if (it != above.end()) {
+        ++rects[*it].h;
+        current.push_back(*it);
+      } else {
+        rects.push_back({c0, r, static_cast<int16_t>(c - c0), 1});
+        current.push_back(rects.size() - 1);
+      }
+    }
+    above.swap(current);
+  }
+
+  auto merge = [](const frame_rect_t &a, const frame_rect_t &b) {
+    int16_t x0 = std::min(a.x, b.x);
+    int16_t y0 = std::min(a.y, b.y);
+    int16_t x1 = std::max(a.x + a.w, b.x + b.w);
+    int16_t y1 = std::max(a.y + a.h, b.y + b.h);
+    return frame_rect_t{x0, y0, static_cast<int16_t>(x1 - x0),
+                        static_cast<int16_t>(y1 - y0)};
+  };
+  auto area = [](const frame_rect_t &a) { return a.w * a.h; };
+  maxRects = std::max<size_t>(maxRects, 1);
+  // pairwise merging is quadratic, a scattered frame becomes one rectangle
+  if (rects.size() > 64) {
+    for (size_t i = 1; i < rects.size(); ++i) {
+      rects[0] = merge(rects[0], rects[i]);
+    }
+    rects.resize(1);
+  }
+  while (rects.size() > maxRects) {
+    size_t bestI = 0;
+    size_t bestJ = 1;
+    int bestCost = INT_MAX;
+    for (size_t i = 0; i < rects.size(); ++i) {
+      for (size_t j = i + 1; j < rects.size(); ++j) {
+        int cost = area(merge(rects[i], rects[j])) - area(rects[i])
+                   - area(rects[j]);
+        if (cost < bestCost) {
+          bestCost = cost;
+          bestI = i;
+          bestJ = j;
+        }
+      }
+    }
+    rects[bestI] = merge(rects[bestI], rects[bestJ]);
+    rects.erase(rects.begin() + bestJ);
+  }
+  return;
+} // end coalesce
+
+/* Rasterizes list band by band, bandRows at a time, and compares it with the
+ * frame stored by the last frameSave() with a word-wide XOR of each row.
+ * Returns the regions that changed in rects, at most maxRects of them, with
+ * x and width aligned to whole tiles.
+ *
+ * Returns false, with the whole frame in rects, if there is no stored frame
+ * to compare against.
+ */
+bool frameDiff(const DisplayList &list, int16_t bandRows, size_t maxRects,
+               std::vector<frame_rect_t> &rects) {
+  int16_t w = list.width();
+  int16_t h = list.height();
+  size_t rowBytes = (w + 7) / 8;
+  size_t rowWords = (rowBytes + 3) / 4;
+  int16_t tileCols = rowWords;
+  int16_t tileRows = (h + FRAME_TILE_H - 1) / FRAME_TILE_H;
+
+  StoredFrame stored;
+  const uint8_t *src = stored.begin();
+  bool compare = src != nullptr && frameWidth == w && frameHeight == h;
+  std::vector<uint8_t> dirty(tileCols * tileRows, 0);
+  std::vector<uint32_t> newRow(rowWords, 0);
+  std::vector<uint32_t> oldRow(rowWords, 0);
+  FrameHash hash(list);
+
+  nextFrame.clear();
+  nextFrame.reserve(frameStore == FRAME_NONE ? FRAME_RTC_BYTES : frameBytes);
+  forEachRow(list, bandRows, [&](int16_t y, const uint8_t *row) {
+    packRow(row, rowBytes, nextFrame);
+    memcpy(newRow.data(), row, rowBytes);
+    if (compare) {
+      src = unpackRow(src, stored.end(),
+                      reinterpret_cast<uint8_t *>(oldRow.data()), rowBytes);
+      compare = src != nullptr;
+    }
+    if (compare) {
+      uint8_t *tiles = &dirty[(y / FRAME_TILE_H) * tileCols];
+      for (size_t i = 0; i < rowWords; ++i) {
+        if (newRow[i] ^ oldRow[i]) {
+          tiles[i] = 1;
+        }
+      }
+    }
+    hash.addRow(y, newRow.data(), rowWords);
+  });
+  nextHash = hash.value();
+  nextWidth = w;
+  nextHeight = h;
+
+  if (!compare) {
+    rects.assign(1, {0, 0, w, h});
+    return false;
+  }
+  coalesce(dirty, tileCols, tileRows, maxRects, rects);
+  for (frame_rect_t &r : rects) {
+    r.x *= FRAME_TILE_W;
+    r.y *= FRAME_TILE_H;
+    r.w = std::min<int16_t>(r.w * FRAME_TILE_W, w - r.x);
+    r.h = std::min<int16_t>(r.h * FRAME_TILE_H, h - r.y);
+  }
+  return true;
+} // end frameDiff
+
+/* Returns true if list looks the same as the frame on the panel, apart from
+ * its volatile regions, so that the panel need not be refreshed at all. The
+ * frame is rasterized bandRows at a time.
+ */
+bool frameUnchanged(const DisplayList &list, int16_t bandRows) {
+  if (!frameHashValid || frameWidth != list.width()
+      || frameHeight != list.height()) {
+    return false;
+  }
+  size_t rowWords = (list.width() + 31) / 32;
+  std::vector<uint32_t> row(rowWords, 0);
+  FrameHash hash(list);
+  forEachRow(list, bandRows, [&](int16_t y, const uint8_t *data) {
+    memcpy(row.data(), data, (list.width() + 7) / 8);
+    hash.addRow(y, row.data(), rowWords);
+  });
+  return hash.value() == frameHash;
+} // end frameUnchanged
+
+/* Copies the stored frame's pixels in r into dst, (r.w + 7) / 8 bytes per
+ * row. r.x must be a multiple of 8. Returns false if there is no stored
+ * frame.
+ */
+bool frameReadPrevious(const frame_rect_t &r, uint8_t *dst) {
+  StoredFrame stored;
+  const uint8_t *src = stored.begin();
+  if (src == nullptr || r.y + r.h > frameHeight) {
+    return false;
+  }
+  size_t rowBytes = (frameWidth + 7) / 8;
+  size_t xb = r.x / 8;
+  size_t wb = (r.w + 7) / 8;
+  std::vector<uint8_t> row(rowBytes);
+  for (int16_t y = 0; y < r.y + r.h; ++y) {
+    src = unpackRow(src, stored.end(), row.data(), rowBytes);
+    if (src == nullptr) {
+      return false;
+    }
+    if (y >= r.y) {
+      memcpy(dst + (y - r.y) * wb, row.data() + xb, wb);
+    }
+  }
+  return true;
+} // end frameReadPrevious
+
+/* Stores nextFrame as the frame on the panel.
+ */
+static void storeNextFrame() {
+  // forget the old frame first, in case of a reset while writing the new one
+  frameStore = FRAME_NONE;
+  frameHash = nextHash;
+  frameHashValid = true;
+  if (nextFrame.size() <= FRAME_RTC_BYTES) {
+    memcpy(frameRtc, nextFrame.data(), nextFrame.size());
+    frameStore = FRAME_RTC;
+  } else if (nextFrame.size() <= FRAME_FLASH_SLOT) {
+    const esp_partition_t *partition = dataPartition();
+    uint32_t slots = partition ? partition->size / FRAME_FLASH_SLOT : 0;
+    uint32_t slot = slots ? (frameSlot + 1) % slots : 0;
+    if (slots > 0
+        && esp_partition_erase_range(partition, slot * FRAME_FLASH_SLOT,
+                                     FRAME_FLASH_SLOT) == ESP_OK
+        && esp_partition_write(partition, slot * FRAME_FLASH_SLOT,
+                               nextFrame.data(), nextFrame.size())
+               == ESP_OK) {
+      frameSlot = slot;
+      frameStore = FRAME_FLASH;
+    }
+  }
+  frameBytes = nextFrame.size();
+  frameWidth = nextWidth;
+  frameHeight = nextHeight;
+  std::vector<uint8_t>().swap(nextFrame);
+  return;
+} // end storeNextFrame
+
+/* Stores the frame compared by the last frameDiff() as the frame on the panel,
+ * once it has been shown. full is true if it was shown with a full refresh.
+ */
+void frameSave(bool full) {
+  partialRefreshes = full ? 0 : partialRefreshes + 1;
+  storeNextFrame();
+  return;
+} // end frameSave
+
+/* Replaces the stored frame's pixels in r with list's, for a region of the
+ * panel that was refreshed without frameDiff(). r.x and r.w must be multiples
+ * of 8, and r must lie within list's volatile regions, as the stored hash is
+ * kept. Returns false if there is no stored frame.
+ */
+bool framePatch(const DisplayList &list, const frame_rect_t &r) {
+  int16_t w = list.width();
+  int16_t h = list.height();
+  size_t rowBytes = (w + 7) / 8;
+  size_t xb = r.x / 8;
+  size_t wb = r.w / 8;
+  std::vector<uint8_t> patched;
+  {
+    StoredFrame stored;
+    const uint8_t *src = stored.begin();
+    if (src == nullptr || frameWidth != w || frameHeight != h
+        || r.y + r.h > h) {
+      return false;
+    }
+    FrameBand band(w, h, r.h);
+    band.setTop(r.y);
+    band.fillScreen(GxEPD_WHITE);
+    band.replay(list);
+    std::vector<uint8_t> row(rowBytes);
+    patched.reserve(frameBytes);
+    for (int16_t y = 0; y < h; ++y) {
+      src = unpackRow(src, stored.end(), row.data(), rowBytes);
+      if (src == nullptr) {
+        return false;
+      }
+      if (y >= r.y && y < r.y + r.h) {
+        memcpy(row.data() + xb, band.buffer() + (y - r.y) * rowBytes + xb,
+               wb);
+      }
+      packRow(row.data(), rowBytes, patched);
+    }
+  } // unmapped before it is overwritten
+  nextFrame.swap(patched);
+  nextWidth = w;
+  nextHeight = h;
+  nextHash = frameHash;
+  storeNextFrame();
+  return true;
+} // end framePatch
+
+/* Returns the number of partial refreshes since the last full refresh.
+ */
+uint32_t framePartialRefreshes() { return partialRefreshes; }
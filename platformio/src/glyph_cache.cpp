@@ -0,0 +1,78 @@
+/* Glyph cache for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+
+#include "glyph_cache.h"
+
+GlyphCache::GlyphCache() {}
+
+/* Returns the rows of glyph c of font, (width + 7) / 8 bytes each, or
+ * nullptr if c is not in the font or the cache is full.
+ */
+const uint8_t *GlyphCache::rows(const GFXfont *font, uint8_t c) {
+  uint8_t first = pgm_read_byte(&font->first);
+  if (c < first || c > pgm_read_byte(&font->last)) {
+    return nullptr;
+  }
+  if (_slots.empty()) {
+    // allocated on first use, lists that are never blitted need none
+    _slots.assign(GLYPH_CACHE_SLOTS, {nullptr, 0, 0});
+    _bytes.reserve(GLYPH_CACHE_BYTES);
+  }
+
+  // open addressing, probing linearly from the hash of font and glyph
+  uintptr_t key = reinterpret_cast<uintptr_t>(font);
+  size_t i = ((key >> 2) * 31 + c) % GLYPH_CACHE_SLOTS;
+  for (size_t n = 0; n < GLYPH_CACHE_SLOTS; ++n) {
+    slot_t &s = _slots[(i + n) % GLYPH_CACHE_SLOTS];
+    if (s.font == font && s.c == c) {
+      return _bytes.data() + s.offset;
+    }
+    if (s.font != nullptr) {
+      continue;
+    }
+
+    const GFXglyph *glyph = &font->glyph[c - first];
+    uint8_t w = pgm_read_byte(&glyph->width);
+    uint8_t h = pgm_read_byte(&glyph->height);
+    size_t rowBytes = (w + 7) / 8;
+    // never grown past what was reserved, so the rows handed out stay put
+    if (_bytes.size() + rowBytes * h > GLYPH_CACHE_BYTES) {
+      return nullptr;
+    }
+    s = {font, static_cast<uint32_t>(_bytes.size()), c};
+    _bytes.resize(_bytes.size() + rowBytes * h, 0);
+    uint8_t *dst = _bytes.data() + s.offset;
+    const uint8_t *src = font->bitmap + pgm_read_word(&glyph->bitmapOffset);
+    uint8_t bits = 0;
+    uint8_t bit = 0;
+    for (uint8_t y = 0; y < h; ++y) {
+      for (uint8_t x = 0; x < w; ++x) {
+        if (!(bit++ & 7)) {
+          bits = pgm_read_byte(src++);
+        }
+        if (bits & 0x80) {
+          dst[y * rowBytes + x / 8] |= 0x80 >> (x % 8);
+        }
+        bits <<= 1;
+      }
+    }
+    return dst;
+  }
+  return nullptr;
+} // end rows
@@ -29,7 +29,11 @@
 #include "config.h"
 #include "display_utils.h"
 #include "icons/icons_196x196.h"
+#include "power_utils.h"
 #include "renderer.h"
+#include "wake_budget.h"
+#include "wake_stub.h"
+#include "widget_cache.h"
 
 #if defined(SENSOR_BME280)
   #include <Adafruit_BME280.h>
@@ -49,12 +53,28 @@ static dwd_resp_onecall_t       dwd_onecall;
 
 Preferences prefs;
 
-/* Put esp32 into ultra low-power deep sleep (<11μA).
- * Aligns wake time to the minute. Sleep times defined in config.cpp.
+#if DISPLAY_CLOCK
+// when the weather update is due while minute wakes update the clock in the
+// meantime, see beginDeepSleep(), otherwise 0
+static RTC_DATA_ATTR time_t weatherWakeTime;
+
+/* Returns when the clock should be updated next: 2s after the next full
+ * minute, to allow for a fast RTC, unless the weather update is due first.
+ */
+time_t nextClockWake(time_t now, time_t weatherWake)
+{
+  return std::min<time_t>(now - now % 60 + 62, weatherWake);
+} // end nextClockWake
+#endif
+
+/* Plans the next wake and returns the time (seconds since the epoch) at which
+ * it should happen. Aligns wake time to the minute. Sleep times defined in
+ * config.cpp.
  */
-void beginDeepSleep(unsigned long startTime, tm *timeInfo)
+time_t planDeepSleep(tm *timeInfo)
 {
-  if (!getLocalTime(timeInfo))
+  // don't let a missing time sync cost the full 5s getLocalTime default
+  if (!getLocalTime(timeInfo, budgetClampTimeout(5000)))
   {
     Serial.println(TXT_REFERENCING_OLDER_TIME_NOTICE);
   }
@@ -106,15 +126,41 @@ void beginDeepSleep(unsigned long startTime, tm *timeInfo)
                     - (timeInfo->tm_min * 60ULL + timeInfo->tm_sec);
   }
 
+  return time(nullptr) + sleepDuration;
+} // end planDeepSleep
+
+/* Put esp32 into ultra low-power deep sleep (<11μA) until wakeTime, as
+ * returned by planDeepSleep. Planning may happen well before this is called,
+ * e.g. while the display is refreshing, so the remaining time is measured now.
+ */
+void beginDeepSleep(unsigned long startTime, time_t wakeTime)
+{
+  time_t now = time(nullptr);
+  uint64_t sleepDuration = wakeTime > now ? wakeTime - now : 0;
+
   // add extra delay to compensate for esp32's with fast RTCs.
   sleepDuration += 3ULL;
   sleepDuration *= 1.0015f;
 
+#if DISPLAY_CLOCK
+  // Wake every minute to update the clock until the weather is due, but not
+  // overnight, the clock stops along with the weather updates then.
+  if (displayShowsClock() && wakeTime - now <= 2 * SLEEP_DURATION * 60)
+  {
+    weatherWakeTime = now + sleepDuration;
+    sleepDuration = nextClockWake(now, weatherWakeTime) - now;
+  }
+#endif
+
 #if DEBUG_LEVEL >= 1
   printHeapUsage();
 #endif
 
+  budgetSaveDiagnostics();
+  wakeStubClear();
   esp_sleep_enable_timer_wakeup(sleepDuration * 1000000ULL);
+  printPhaseStats();
+  budgetPrintStats();
   Serial.print(TXT_AWAKE_FOR);
   Serial.println(" "  + String((millis() - startTime) / 1000.0, 3) + "s");
   Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
@@ -122,6 +168,83 @@ void beginDeepSleep(unsigned long startTime, tm *timeInfo)
   esp_deep_sleep_start();
 } // end beginDeepSleep
 
+/* Arms the low battery back-off timer.
+ * Battery checks that would land between BED_TIME and WAKE_TIME cannot result
+ * in a display update, so they are added to the wake stub schedule instead.
+ * The stub absorbs those wakes without booting, and the next full boot happens
+ * at the first check after WAKE_TIME.
+ */
+void armLowBatterySleep(unsigned long intervalMinutes)
+{
+  const uint64_t intervalSeconds = intervalMinutes * 60ULL;
+  wakeStubClear();
+  esp_sleep_enable_timer_wakeup(intervalSeconds * 1000000ULL);
+  if (BED_TIME == WAKE_TIME)
+  {
+    return;
+  }
+
+  // The system time keeps running in deep sleep, but the time zone does not
+  // survive it. If the time was never synchronized there is nothing to plan.
+  setenv("TZ", TIMEZONE, 1);
+  tzset();
+  tm timeInfo = {};
+  if (!getLocalTime(&timeInfo, 0))
+  {
+    return;
+  }
+
+  // time is relative to wake time, see planDeepSleep
+  const int bedtimeMinute = ((BED_TIME - WAKE_TIME + 24) % 24) * 60;
+  int wakeMinute = ((timeInfo.tm_hour - WAKE_TIME + 24) % 24) * 60
+                   + timeInfo.tm_min + intervalMinutes;
+  while (wakeMinute % (24 * 60) >= bedtimeMinute
+         && wakeStubAddSkip(intervalSeconds))
+  {
+    wakeMinute += intervalMinutes;
+  }
+#if DEBUG_LEVEL >= 1
+  Serial.println("[debug] Wake stub slots: " + String(wakeStubSlots()));
+#endif
+  return;
+} // end armLowBatterySleep
+
+#if DISPLAY_CLOCK
+/* Minute wake between weather updates. Updates the clock with a partial
+ * refresh of just its box and goes straight back to sleep, without WiFi,
+ * sensors or the weather. Returns if the display shows no clock or the time
+ * is unknown, the weather is updated instead then.
+ */
+void updateClock(unsigned long startTime)
+{
+  // the system time keeps running in deep sleep, the time zone does not
+  setenv("TZ", TIMEZONE, 1);
+  tzset();
+  tm timeInfo = {};
+  if (!displayShowsClock() || !getLocalTime(&timeInfo, 0))
+  {
+    return;
+  }
+  initDisplay();
+  bool updated = refreshClock(timeInfo);
+  powerOffDisplay();
+  if (!updated)
+  {
+    return;
+  }
+
+  time_t now = time(nullptr);
+  time_t wakeTime = nextClockWake(now, weatherWakeTime);
+  uint64_t sleepDuration = wakeTime > now ? wakeTime - now : 1;
+  esp_sleep_enable_timer_wakeup(sleepDuration * 1000000ULL);
+  Serial.print(TXT_AWAKE_FOR);
+  Serial.println(" "  + String((millis() - startTime) / 1000.0, 3) + "s");
+  Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
+  Serial.println(" " + String(sleepDuration) + "s");
+  esp_deep_sleep_start();
+} // end updateClock
+#endif
+
 /* Program entry point.
  */
 void setup()
@@ -129,8 +252,21 @@ void setup()
   unsigned long startTime = millis();
   Serial.begin(115200);
 
+#if DISPLAY_CLOCK
+  // timer wakes before the weather is due only update the clock
+  if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_TIMER
+      && time(nullptr) + 30 < weatherWakeTime)
+  {
+    updateClock(startTime);
+  }
+  weatherWakeTime = 0;
+#endif
+
 #if DEBUG_LEVEL >= 1
   printHeapUsage();
+  Serial.println("[debug] Wakes absorbed by stub: "
+                 + String(wakeStubSkippedWakes()));
+  budgetPrintDiagnostics();
 #endif
 
   disableBuiltinLED();
@@ -156,33 +292,34 @@ void setup()
     { // battery is now low for the first time
       prefs.putBool("lowBat", true);
       prefs.end();
-      initDisplay();
-      do
+      beginFrame();
+      drawError(battery_alert_0deg_196x196, TXT_LOW_BATTERY);
+      if (!displayUnchanged())
       {
-        drawError(battery_alert_0deg_196x196, TXT_LOW_BATTERY);
-      } while (display.nextPage());
-      powerOffDisplay();
+        initDisplay();
+        refreshDisplay();
+        powerOffDisplay();
+      }
     }
 
     if (batteryVoltage <= CRIT_LOW_BATTERY_VOLTAGE)
     { // critically low battery
       // don't set esp_sleep_enable_timer_wakeup();
       // We won't wake up again until someone manually presses the RST button.
+      wakeStubClear();
       Serial.println(TXT_CRIT_LOW_BATTERY_VOLTAGE);
       Serial.println(TXT_HIBERNATING_INDEFINITELY_NOTICE);
     }
     else if (batteryVoltage <= VERY_LOW_BATTERY_VOLTAGE)
     { // very low battery
-      esp_sleep_enable_timer_wakeup(VERY_LOW_BATTERY_SLEEP_INTERVAL
-                                    * 60ULL * 1000000ULL);
+      armLowBatterySleep(VERY_LOW_BATTERY_SLEEP_INTERVAL);
       Serial.println(TXT_VERY_LOW_BATTERY_VOLTAGE);
       Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
       Serial.println(" " + String(VERY_LOW_BATTERY_SLEEP_INTERVAL) + "min");
     }
     else
     { // low battery
-      esp_sleep_enable_timer_wakeup(LOW_BATTERY_SLEEP_INTERVAL
-                                    * 60ULL * 1000000ULL);
+      armLowBatterySleep(LOW_BATTERY_SLEEP_INTERVAL);
       Serial.println(TXT_LOW_BATTERY_VOLTAGE);
       Serial.print(TXT_ENTERING_DEEP_SLEEP_FOR);
       Serial.println(" " + String(LOW_BATTERY_SLEEP_INTERVAL) + "min");
@@ -206,30 +343,30 @@ void setup()
   tm timeInfo = {};
 
   // START WIFI
+  enterPhase(PHASE_NETWORK);
   int wifiRSSI = 0; // “Received Signal Strength Indicator"
   wl_status_t wifiStatus = startWiFi(wifiRSSI);
   if (wifiStatus != WL_CONNECTED)
   { // WiFi Connection Failed
     killWiFi();
-    initDisplay();
-    if (wifiStatus == WL_NO_SSID_AVAIL)
-    {
-      Serial.println(TXT_NETWORK_NOT_AVAILABLE);
-      do
-      {
-        drawError(wifi_x_196x196, TXT_NETWORK_NOT_AVAILABLE);
-      } while (display.nextPage());
-    }
-    else
+    const char *errMsg = wifiStatus == WL_NO_SSID_AVAIL
+                         ? TXT_NETWORK_NOT_AVAILABLE
+                         : TXT_WIFI_CONNECTION_FAILED;
+    Serial.println(errMsg);
+    // Out of budget, keep showing the last forecast rather than spending more
+    // on an error screen. The same applies to the errors below.
+    if (!budgetExhausted())
     {
-      Serial.println(TXT_WIFI_CONNECTION_FAILED);
-      do
+      beginFrame();
+      drawError(wifi_x_196x196, errMsg);
+      if (!displayUnchanged())
       {
-        drawError(wifi_x_196x196, TXT_WIFI_CONNECTION_FAILED);
-      } while (display.nextPage());
+        initDisplay();
+        refreshDisplay();
+        powerOffDisplay();
+      }
     }
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
+    beginDeepSleep(startTime, planDeepSleep(&timeInfo));
   }
 
   // TIME SYNCHRONIZATION
@@ -239,13 +376,18 @@ void setup()
   {
     Serial.println(TXT_TIME_SYNCHRONIZATION_FAILED);
     killWiFi();
-    initDisplay();
-    do
+    if (!budgetExhausted())
     {
+      beginFrame();
       drawError(wi_time_4_196x196, TXT_TIME_SYNCHRONIZATION_FAILED);
-    } while (display.nextPage());
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
+      if (!displayUnchanged())
+      {
+        initDisplay();
+        refreshDisplay();
+        powerOffDisplay();
+      }
+    }
+    beginDeepSleep(startTime, planDeepSleep(&timeInfo));
   }
 
   // MAKE API REQUESTS
@@ -264,18 +406,24 @@ void setup()
     killWiFi();
     statusStr = "One Call " + OWM_ONECALL_VERSION + " API";
     tmpStr = String(rxStatus, DEC) + ": " + getHttpResponsePhrase(rxStatus);
-    initDisplay();
-    do
+    if (!budgetExhausted())
     {
+      beginFrame();
       drawError(wi_cloud_down_196x196, statusStr, tmpStr);
-    } while (display.nextPage());
-    powerOffDisplay();
-    beginDeepSleep(startTime, &timeInfo);
+      if (!displayUnchanged())
+      {
+        initDisplay();
+        refreshDisplay();
+        powerOffDisplay();
+      }
+    }
+    beginDeepSleep(startTime, planDeepSleep(&timeInfo));
   }
 
   killWiFi(); // WiFi no longer needed
 
   // GET INDOOR TEMPERATURE AND HUMIDITY, start BMEx80...
+  enterPhase(PHASE_SENSOR);
   pinMode(PIN_BME_PWR, OUTPUT);
   digitalWrite(PIN_BME_PWR, HIGH);
   TwoWire I2C_bme = TwoWire(0);
@@ -313,28 +461,60 @@ void setup()
   }
   digitalWrite(PIN_BME_PWR, LOW);
 
+  enterPhase(PHASE_RENDER);
   String refreshTimeStr;
   getRefreshTimeStr(refreshTimeStr, timeConfigured, &timeInfo);
   String dateStr;
   getDateStr(dateStr, &timeInfo);
 
   // RENDER FULL REFRESH
-  initDisplay();
-  do
+  beginFrame();
+  drawBackground();
+  Serial.println("DrawCurrentConditions\n");
+  drawCurrentConditions(dwd_onecall.current, dwd_onecall.days[0], inTemp, inHumidity);
+  Serial.println("DrawOutlook\n");
+  drawOutlookGraph(dwd_onecall.hours, dwd_onecall.days, timeInfo);
+  Serial.println("DrawForecast\n");
+  drawForecast(dwd_onecall.days, timeInfo);
+  drawLocationDate(CITY_STRING, dateStr);
+#if DISPLAY_CLOCK
+  if (timeConfigured)
   {
-    Serial.println("DrawCurrentConditions\n");
-    drawCurrentConditions(dwd_onecall.current, dwd_onecall.days[0], inTemp, inHumidity);
-    Serial.println("DrawOutlook\n");
-    drawOutlookGraph(dwd_onecall.hours, dwd_onecall.days, timeInfo);
-    Serial.println("DrawForecast\n");
-    drawForecast(dwd_onecall.days, timeInfo);
-    drawLocationDate(CITY_STRING, dateStr);
-    drawStatusBar(statusStr, refreshTimeStr, wifiRSSI, batteryVoltage);
-  } while (display.nextPage());
-  powerOffDisplay();
+    drawClock(timeInfo);
+  }
+#endif
+  drawStatusBar(statusStr, refreshTimeStr, wifiRSSI, batteryVoltage);
+#if WIDGET_CACHE
+  widgetCacheReport();
+#endif
+
+  // The panel refresh is by far the most expensive part of a wake. If the
+  // frame has not changed, the display is not even powered on.
+  bool refresh = !displayUnchanged();
+  enterPhase(PHASE_DISPLAY);
+  if (refresh)
+  {
+    initDisplay();
+    refreshDisplayAsync(inTemp);
+  }
+  else
+  {
+    Serial.println("Display unchanged, not refreshed");
+  }
+
+  // The panel is now refreshing in the background, which takes several
+  // seconds. Anything that doesn't need the display should be done here.
+  time_t wakeTime = planDeepSleep(&timeInfo);
+  budgetSaveDiagnostics();
+
+  if (refresh)
+  {
+    waitRefreshDone();
+    powerOffDisplay();
+  }
 
   // DEEP SLEEP
-  beginDeepSleep(startTime, &timeInfo);
+  beginDeepSleep(startTime, wakeTime);
 } // end setup
 
 /* This will never run
@@ -0,0 +1,170 @@
+/* Power management for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <esp_pm.h>
+
+#include "config.h"
+#include "power_utils.h"
+
+static const char *PHASE_NAMES[PHASE_COUNT] = {
+    "Boot", "Network", "Parse", "Sensor", "Render", "Display"};
+
+static wake_phase_t phase = PHASE_BOOT;
+static uint64_t phaseStart = 0;           // us since boot
+static uint64_t phaseMicros[PHASE_COUNT]; // accumulated time in each phase
+static uint32_t phaseMHz[PHASE_COUNT];    // cpu frequency used in each phase
+
+#if CONFIG_PM_ENABLE
+static bool pmAvailable = true;         // esp_pm_configure() usable
+#endif
+static bool lightSleepAvailable = true; // automatic light sleep supported
+static bool lightSleepEnabled = false;
+static uint64_t lightSleepStart = 0;
+static uint64_t lightSleepMicros = 0;
+
+/* Sets the CPU frequency and whether the CPU may enter light sleep whenever
+ * FreeRTOS is idle.
+ *
+ * Automatic light sleep requires power management and tickless idle to be
+ * enabled in the framework's sdkconfig. If it is not available the CPU still
+ * idles in the blocking waits, just without light sleep.
+ */
+static void applyClock(uint32_t mhz, bool lightSleep) {
+#if CONFIG_PM_ENABLE
+  if (pmAvailable) {
+    esp_pm_config_esp32_t pmConfig = {};
+    pmConfig.max_freq_mhz = mhz;
+    pmConfig.min_freq_mhz = mhz; // frequency is switched per phase instead
+    pmConfig.light_sleep_enable = lightSleep && lightSleepAvailable;
+    esp_err_t err = esp_pm_configure(&pmConfig);
+    if (err != ESP_OK && pmConfig.light_sleep_enable) {
+      lightSleepAvailable = false;
+      pmConfig.light_sleep_enable = false;
+      err = esp_pm_configure(&pmConfig);
+    }
+    if (err != ESP_OK) {
+      pmAvailable = false;
+      lightSleepAvailable = false;
+    }
+  }
+#else
+  lightSleepAvailable = false;
+#endif
+  if (getCpuFrequencyMhz() != mhz) {
+    setCpuFrequencyMhz(mhz);
+  }
+  return;
+} // end applyClock
+
+/* Returns the CPU frequency (MHz) to be used for the given phase.
+ * Parsing and rendering are CPU-bound and finish sooner, and so use less
+ * energy, at a high clock. Everything else is waiting on a radio, sensor or the
+ * e-paper panel, and gains nothing from a fast clock.
+ */
+uint32_t getPhaseFrequency(wake_phase_t p) {
+  switch (p) {
+  case PHASE_PARSE:
+  case PHASE_RENDER:
+    return CPU_FREQ_HIGH;
+  default:
+    return CPU_FREQ_LOW;
+  }
+} // end getPhaseFrequency
+
+/* Ends the current phase and begins the next one, switching the CPU frequency
+ * if required. Time spent in each phase is accumulated, so a phase may be
+ * entered more than once per wake.
+ */
+void enterPhase(wake_phase_t next) {
+  uint64_t now = micros();
+  phaseMicros[phase] += now - phaseStart;
+  phaseMHz[phase] = getCpuFrequencyMhz();
+  phaseStart = now;
+  phase = next;
+
+  applyClock(getPhaseFrequency(next), lightSleepEnabled);
+  return;
+} // end enterPhase
+
+/* Enables or disables automatic light sleep. This should be enabled only
+ * around blocking waits (WiFi, SNTP, e-paper busy), where the waiting task is
+ * woken by an event or interrupt instead of polling.
+ */
+void setAutoLightSleep(bool enable) {
+  if (enable == lightSleepEnabled) {
+    return;
+  }
+  uint64_t now = micros();
+  if (enable) {
+    lightSleepStart = now;
+  } else {
+    lightSleepMicros += now - lightSleepStart;
+  }
+  lightSleepEnabled = enable;
+  applyClock(getPhaseFrequency(phase), enable);
+  return;
+} // end setAutoLightSleep
+
+/* Returns the time spent blocked in waits that allow automatic light sleep
+ * (us).
+ */
+uint64_t getLightSleepMicros() {
+  uint64_t t = lightSleepMicros;
+  if (lightSleepEnabled) {
+    t += micros() - lightSleepStart;
+  }
+  return t;
+} // end getLightSleepMicros
+
+/* Returns the phase the firmware is currently in.
+ */
+wake_phase_t currentPhase() { return phase; }
+
+/* Returns the time spent in the given phase (us), including the time spent so
+ * far if it is the current phase.
+ */
+uint64_t getPhaseMicros(wake_phase_t p) {
+  uint64_t t = phaseMicros[p];
+  if (p == phase) {
+    t += micros() - phaseStart;
+  }
+  return t;
+} // end getPhaseMicros
+
+/* Returns the name of the given phase.
+ */
+const char *getPhaseName(wake_phase_t p) { return PHASE_NAMES[p]; }
+
+/* Prints the time spent in each phase and the CPU frequency it ran at.
+ */
+void printPhaseStats() {
+  phaseMHz[phase] = getCpuFrequencyMhz();
+  for (int p = 0; p < PHASE_COUNT; ++p) {
+    wake_phase_t wp = static_cast<wake_phase_t>(p);
+    uint64_t us = getPhaseMicros(wp);
+    if (us == 0) {
+      continue;
+    }
+    Serial.printf("%-8s %4luMHz %8.3fs\n", PHASE_NAMES[p],
+                  static_cast<unsigned long>(phaseMHz[p]), us / 1000000.0);
+  }
+  Serial.printf("%-15s %8.3fs%s\n", "Light sleep",
+                getLightSleepMicros() / 1000000.0,
+                lightSleepAvailable ? "" : " (unavailable, idle only)");
+  return;
+} // end printPhaseStats
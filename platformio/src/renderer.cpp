@@ -15,19 +15,43 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
 #include "renderer.h"
 #include "HardwareSerial.h"
 #include "Print.h"
 #include "_locale.h"
 #include "_strftime.h"
 #include "api_response.h"
+#include "chart.h"
 #include "config.h"
 #include "conversions.h"
 #include "display_utils.h"
+#include "frame_diff.h"
+#include "layout.h"
+#include "power_utils.h"
+#include "text_metrics.h"
+#include "widget_cache.h"
+#include <driver/gpio.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 // fonts
 #include FONT_HEADER
 
+// fonts of the layout widgets, by layout_font_t
+static const GFXfont *const layoutFonts[] = {
+    nullptr,      &FONT_6pt8b,  &FONT_8pt8b,  &FONT_11pt8b,
+    &FONT_12pt8b, &FONT_16pt8b, &FONT_26pt8b, &FONT_48pt8b_temperature};
+static_assert(sizeof(layoutFonts) / sizeof(layoutFonts[0])
+                  == LAYOUT_FONT_TEMPERATURE + 1,
+              "one font for each layout_font_t");
+
 // icon header files
 #include "icons/icons_128x128.h"
 #include "icons/icons_160x160.h"
@@ -40,29 +64,150 @@
 #include "icons/icons_96x96.h"
 
 #ifdef DISP_BW_V2
-GxEPD2_BW<GxEPD2_750_T7, GxEPD2_750_T7::HEIGHT>
-    display(GxEPD2_750_T7(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST, PIN_EPD_BUSY));
+display_t display(GxEPD2_750_T7_Fast(PIN_EPD_CS, PIN_EPD_DC, PIN_EPD_RST,
+                                PIN_EPD_BUSY));
 #endif
 
 #ifndef ACCENT_COLOR
 #define ACCENT_COLOR GxEPD_BLACK
 #endif
 
+// widgets are copied from the stored frame, which has no colors
+#if WIDGET_CACHE && !defined(DISP_3C_B) && !defined(DISP_7C_F)
+#define CACHE_WIDGETS 1
+#else
+#define CACHE_WIDGETS 0
+#endif
+
+typedef enum refresh_mode : uint8_t
+{
+  REFRESH_NONE,
+  REFRESH_FULL,
+  REFRESH_FAST,
+  REFRESH_PARTIAL
+} refresh_mode_t;
+
+// how the panel was last refreshed, and the fast full refreshes since the
+// last clean one, kept across deep sleep
+static RTC_DATA_ATTR refresh_mode_t lastRefreshMode;
+static RTC_DATA_ATTR uint32_t lastRefreshMillis;
+static RTC_DATA_ATTR uint32_t fastRefreshes;
+// indoor temperature the next refresh is done at
+static float panelTemperature = NAN;
+
+// the clock, see drawClock(): where its text is anchored (right aligned), the
+// byte aligned box any time fits into, the time on the panel and the time in
+// the stored frame, which the minute wakes leave as it is. Kept across deep
+// sleep. nextClock is the clock of the frame being drawn, which takes over
+// once that frame is on the panel.
+typedef struct clock_state
+{
+  bool valid;
+  int16_t x;
+  int16_t y;
+  frame_rect_t box;
+  char panelText[12];
+  char frameText[12];
+} clock_state_t;
+static RTC_DATA_ATTR clock_state_t clockState;
+static clock_state_t nextClock;
+// left edge of the location and date, see drawLocationDate()
+static thread_local int16_t locationLeft = DISP_WIDTH;
+// the indoor temperature, icon and text, sits a little left in its box
+static const int indoorTempOffset = -4;
+
+// The parts of the weather screen that do not depend on the data, recorded
+// once after a reset, see drawBackground(). The calls point to icons and fonts
+// in flash, which stay where they are across deep sleep. backgroundEnd is the
+// number of calls at the start of the frame being drawn that are background.
+#define BACKGROUND_CALLS 16
+static RTC_DATA_ATTR dl_op_t backgroundCalls[BACKGROUND_CALLS];
+static RTC_DATA_ATTR uint8_t backgroundSize;
+static size_t backgroundEnd;
+
+// the frame drawn by the firmware, replayed into display one page at a time.
+// The dashboard records 200-700 draw calls, depending on the forecast.
+static DisplayList displayList(DISP_WIDTH, DISP_HEIGHT, 768);
+
+// what the drawing functions below draw into, per task, see setRenderTarget()
+static thread_local DisplayList *target = nullptr;
+
+/* Makes the drawing functions below record into the given display list
+ * instead of the firmware's own, for the calling task only, so that frames can
+ * be rendered by several tasks at once. nullptr restores the firmware's list.
+ *
+ * Display control (initDisplay, refreshDisplay, powerOffDisplay) always
+ * operates on display.
+ */
+void setRenderTarget(DisplayList *t) {
+  target = t;
+  return;
+} // end setRenderTarget
+
+/* Returns the display list the calling task draws into.
+ */
+DisplayList &renderTarget() { return target ? *target : displayList; }
+
+/* Selects the font the text of a widget is drawn in, see layout.h.
+ */
+static void setLayoutFont(const layout_widget_t &widget) {
+  renderTarget().setFont(layoutFonts[widget.font]);
+  return;
+} // end setLayoutFont
+
+/* Draws a widget of the firmware's frame by copying it from the frame on the
+ * panel, if its inputs hash to the same as when it was drawn there, see
+ * widgetCacheDraw(). Returns false if it has to be drawn, which is always the
+ * case for other frames.
+ */
+static bool drawCachedWidget(widget_cache_slot_t slot, uint32_t hash,
+                             int16_t &value) {
+#if CACHE_WIDGETS
+  DisplayList &gfx = renderTarget();
+  return &gfx == &displayList && widgetCacheDraw(gfx, slot, hash, value);
+#else
+  return false;
+#endif
+} // end drawCachedWidget
+
+/* Same as above, for widgets that need no value handed back.
+ */
+static bool drawCachedWidget(widget_cache_slot_t slot, uint32_t hash) {
+  int16_t value;
+  return drawCachedWidget(slot, hash, value);
+} // end drawCachedWidget
+
+/* Records that a widget of the firmware's frame was drawn, with the calls
+ * since first, see widgetCacheAdd().
+ */
+static void addCachedWidget(widget_cache_slot_t slot, uint32_t hash,
+                            size_t first, int16_t value = 0) {
+#if CACHE_WIDGETS
+  DisplayList &gfx = renderTarget();
+  if (&gfx == &displayList) {
+    widgetCacheAdd(gfx, slot, hash, first, value);
+  }
+#endif
+  return;
+} // end addCachedWidget
+
 /* Returns the string width in pixels
  */
 uint16_t getStringWidth(const String &text) {
+  DisplayList &gfx = renderTarget();
   int16_t x1, y1;
   uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  gfx.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
   return w;
 }
 
 /* Returns the string height in pixels
  */
 uint16_t getStringHeight(const String &text) {
+  DisplayList &gfx = renderTarget();
   int16_t x1, y1;
   uint16_t w, h;
-  display.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
+  gfx.getTextBounds(text, 0, 0, &x1, &y1, &w, &h);
   return h;
 }
 
@@ -70,24 +215,25 @@ uint16_t getStringHeight(const String &text) {
  */
 void drawString(int16_t x, int16_t y, const String &text, alignment_t alignment,
                 uint16_t color) {
+  DisplayList &gfx = renderTarget();
   int16_t x1, y1;
   uint16_t w, h;
-  display.setTextColor(color);
-  display.getTextBounds(text, x, y, &x1, &y1, &w, &h);
+  gfx.setTextColor(color);
+  gfx.getTextBounds(text, x, y, &x1, &y1, &w, &h);
   if (alignment == RIGHT) {
     x = x - w;
   }
   if (alignment == CENTER) {
     x = x - w / 2;
   }
-  display.setCursor(x, y);
-  display.print(text);
+  gfx.setCursor(x, y);
+  gfx.print(text);
   return;
 } // end drawString
 
 /* Draws a string that will flow into the next line when max_width is reached.
  * If a string exceeds max_lines an ellipsis (...) will terminate the last word.
- * Lines will break at spaces(' ') and dashes('-').
+ * Lines will break at spaces(' ') and dashes('-'), see breakLine().
  *
  * Note: max_width should be big enough to accommodate the largest word that
  *       will be displayed. If an unbroken string of characters longer than
@@ -98,164 +244,464 @@ void drawMultiLnString(int16_t x, int16_t y, const String &text,
                        alignment_t alignment, uint16_t max_width,
                        uint16_t max_lines, int16_t line_spacing,
                        uint16_t color) {
-  uint16_t current_line = 0;
-  String textRemaining = text;
-  // print until we reach max_lines or no more text remains
-  while (current_line < max_lines && !textRemaining.isEmpty()) {
-    int16_t x1, y1;
-    uint16_t w, h;
-
-    display.getTextBounds(textRemaining, 0, 0, &x1, &y1, &w, &h);
-
-    int endIndex = textRemaining.length();
-    // check if remaining text is to wide, if it is then print what we can
-    String subStr = textRemaining;
-    int splitAt = 0;
-    int keepLastChar = 0;
-    while (w > max_width && splitAt != -1) {
-      if (keepLastChar) {
-        // if we kept the last character during the last iteration of this while
-        // loop, remove it now so we don't get stuck in an infinite loop.
-        subStr.remove(subStr.length() - 1);
-      }
-
-      // find the last place in the string that we can break it.
-      if (current_line < max_lines - 1) {
-        splitAt = std::max(subStr.lastIndexOf(" "), subStr.lastIndexOf("-"));
-      } else {
-        // this is the last line, only break at spaces so we can add ellipsis
-        splitAt = subStr.lastIndexOf(" ");
-      }
-
-      // if splitAt == -1 then there is an unbroken set of characters that is
-      // longer than max_width. Otherwise if splitAt != -1 then we can continue
-      // the loop until the string is <= max_width
-      if (splitAt != -1) {
-        endIndex = splitAt;
-        subStr = subStr.substring(0, endIndex + 1);
-
-        char lastChar = subStr.charAt(endIndex);
-        if (lastChar == ' ') {
-          // remove this char now so it is not counted towards line width
-          keepLastChar = 0;
-          subStr.remove(endIndex);
-          --endIndex;
-        } else if (lastChar == '-') {
-          // this char will be printed on this line and removed next iteration
-          keepLastChar = 1;
-        }
-
-        if (current_line < max_lines - 1) {
-          // this is not the last line
-          display.getTextBounds(subStr, 0, 0, &x1, &y1, &w, &h);
-        } else {
-          // this is the last line, we need to make sure there is space for
-          // ellipsis
-          display.getTextBounds(subStr + "...", 0, 0, &x1, &y1, &w, &h);
-          if (w <= max_width) {
-            // ellipsis fit, add them to subStr
-            subStr = subStr + "...";
-          }
-        }
-
-      } // end if (splitAt != -1)
-    }   // end inner while
-
-    drawString(x, y + (current_line * line_spacing), subStr, alignment, color);
-
-    // update textRemaining to no longer include what was printed
-    // +1 for exclusive bounds, +1 to get passed space/dash
-    textRemaining = textRemaining.substring(endIndex + 2 - keepLastChar);
-
-    ++current_line;
-  } // end outer while
-
+  DisplayList &gfx = renderTarget();
+  if (gfx.font() == nullptr) {
+    drawString(x, y, text, alignment, color);
+    return;
+  }
+  gfx.setTextColor(color);
+  const char *remaining = text.c_str();
+  for (uint16_t line = 0; line < max_lines && *remaining; ++line) {
+    text_line_t l = breakLine(gfx.font(), remaining, max_width,
+                              line == max_lines - 1);
+    // lines are printed straight from text, aligned by the width breakLine()
+    // measured, see drawString()
+    int16_t lx = x;
+    if (alignment == RIGHT) {
+      lx = x - l.width;
+    }
+    if (alignment == CENTER) {
+      lx = x - l.width / 2;
+    }
+    gfx.setCursor(lx, y + line * line_spacing);
+    gfx.write(reinterpret_cast<const uint8_t *>(remaining), l.len);
+    if (l.ellipsis) {
+      gfx.print("...");
+    }
+    remaining += l.next;
+  }
   return;
 } // end drawMultiLnString
 
+// given by the BUSY pin interrupt, taken by the task waiting on the panel
+static SemaphoreHandle_t epdBusySem = nullptr;
+
+/* Interrupt handler for any edge on the e-paper BUSY pin.
+ */
+static void IRAM_ATTR epdBusyISR() {
+  BaseType_t woken = pdFALSE;
+  xSemaphoreGiveFromISR(epdBusySem, &woken);
+  if (woken) {
+    portYIELD_FROM_ISR();
+  }
+} // end epdBusyISR
+
+/* Called repeatedly by GxEPD2 while the panel is busy, in place of its
+ * delay(1) polling. Blocks until the BUSY pin changes (or a short timeout so a
+ * missed edge can't stall the refresh), letting the CPU light sleep. The pin
+ * level is also a light sleep wakeup source, so the edge that ends the busy
+ * period wakes the CPU.
+ */
+static void epdBusyCallback(const void *) {
+  gpio_num_t pin = static_cast<gpio_num_t>(PIN_EPD_BUSY);
+  gpio_wakeup_enable(pin, gpio_get_level(pin) ? GPIO_INTR_LOW_LEVEL
+                                              : GPIO_INTR_HIGH_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+  setAutoLightSleep(true);
+  xSemaphoreTake(epdBusySem, pdMS_TO_TICKS(50));
+  setAutoLightSleep(false);
+  gpio_wakeup_disable(pin);
+  return;
+} // end epdBusyCallback
+
 /* Initialize e-paper display
  */
 void initDisplay() {
   pinMode(PIN_EPD_PWR, OUTPUT);
   digitalWrite(PIN_EPD_PWR, HIGH);
+  // not initial: full refreshes write the whole frame anyway, and partial
+  // refreshes restore the previous image themselves, see restorePrevious()
 #ifdef DRIVER_WAVESHARE
-  display.init(115200, true, 2, false);
+  display.init(115200, false, 2, false);
 #endif
 #ifdef DRIVER_DESPI_C02
-  display.init(115200, true, 10, false);
+  display.init(115200, false, 10, false);
 #endif
   // remap spi
   SPI.end();
   SPI.begin(PIN_EPD_SCK, PIN_EPD_MISO, PIN_EPD_MOSI, PIN_EPD_CS);
 
-  display.setRotation(0);
-  display.setTextSize(1);
-  display.setTextColor(GxEPD_BLACK);
-  display.setTextWrap(false);
-  // display.fillScreen(GxEPD_WHITE);
-  display.setFullWindow();
-  display.firstPage(); // use paged drawing mode, sets fillScreen(GxEPD_WHITE)
+  // wait for the BUSY pin by interrupt instead of polling
+  if (epdBusySem == nullptr) {
+    epdBusySem = xSemaphoreCreateBinary();
+  }
+  attachInterrupt(PIN_EPD_BUSY, epdBusyISR, CHANGE);
+  display.epd2.setBusyCallback(epdBusyCallback);
   return;
 } // end initDisplay
 
+/* Starts a new frame in the calling task's display list. Everything drawn
+ * until the next drawFrame() or refreshDisplay() is part of it.
+ */
+void beginFrame() {
+  DisplayList &gfx = renderTarget();
+  gfx.clear();
+  if (&gfx == &displayList) {
+    nextClock.valid = false;
+    backgroundEnd = 0;
+#if CACHE_WIDGETS
+    widgetCacheBegin();
+#endif
+  }
+  gfx.setRotation(0);
+  gfx.setTextSize(1);
+  gfx.setTextColor(GxEPD_BLACK);
+  gfx.setTextWrap(false);
+  return;
+} // end beginFrame
+
+/* Rasterizes a display list into a frame buffer one page band at a time. With
+ * a paged buffer each page is written to the panel as it is completed, and
+ * the panel is refreshed after the last one. If window is given only that
+ * region is drawn and refreshed, with a partial refresh.
+ */
+static void replayFrame(const DisplayList &list, display_t &frame,
+                        const frame_rect_t *window = nullptr) {
+  frame.setRotation(0);
+  int16_t y0 = 0;
+  int16_t h = frame.height();
+  if (window) {
+    frame.setPartialWindow(window->x, window->y, window->w, window->h);
+    y0 = window->y;
+    h = window->h;
+  } else {
+    frame.setFullWindow();
+  }
+  frame.firstPage(); // use paged drawing mode, sets fillScreen(GxEPD_WHITE)
+  int16_t pageHeight = frame.pageHeight();
+  uint16_t page = 0;
+  do {
+    int16_t top = y0 + page * pageHeight;
+    int16_t bottom = std::min<int16_t>(top + pageHeight, y0 + h) - 1;
+    list.replay(frame, top, bottom);
+    // pages are written a second time after a refresh, starting over at 0
+    ++page;
+    if (page * pageHeight >= h) {
+      page = 0;
+    }
+  } while (frame.nextPage());
+  return;
+} // end replayFrame
+
+/* Draws the calling task's frame into a frame buffer. For display this also
+ * updates the panel, with a full refresh, and returns once the refresh has
+ * completed.
+ */
+void drawFrame(display_t &frame) {
+  replayFrame(renderTarget(), frame);
+  return;
+} // end drawFrame
+
+/* Writes the previous frame's pixels in r to the controller's previous image,
+ * which a partial refresh compares the new image against to find the pixels
+ * it has to drive. The controller's memory is lost while it is powered off
+ * between wakes.
+ */
+static void restorePrevious(const frame_rect_t &r) {
+  size_t rowBytes = (r.w + 7) / 8;
+  int16_t chunkRows = std::max<int16_t>(1, std::min<size_t>(r.h,
+                                        (DISP_WIDTH / 8) * 16 / rowBytes));
+  std::vector<uint8_t> buf(rowBytes * chunkRows);
+  for (int16_t y = r.y; y < r.y + r.h; y += chunkRows) {
+    int16_t rows = std::min<int16_t>(chunkRows, r.y + r.h - y);
+    if (frameReadPrevious({r.x, y, r.w, rows}, buf.data())) {
+      display.epd2.writeImageAgain(buf.data(), r.x, y, r.w, rows);
+    }
+  }
+  return;
+} // end restorePrevious
+
+/* Records the clock showing text into list, see drawClock().
+ */
+static void recordClock(DisplayList &list, const clock_state_t &clock,
+                        const char *text) {
+  DisplayList *t = target;
+  setRenderTarget(&list);
+  list.setFont(&FONT_26pt8b);
+  drawString(clock.x, clock.y, text, RIGHT);
+  setRenderTarget(t);
+  return;
+} // end recordClock
+
+/* Selects the waveform of the next full refresh. Only the 7.5in (800x480)
+ * panel has a fast one. Returns whether it will be fast.
+ */
+static bool setFastFullRefresh(bool fast) {
+#ifdef DISP_BW_V2
+  display.epd2.setFastFullRefresh(fast);
+  return fast;
+#else
+  return false;
+#endif
+} // end setFastFullRefresh
+
+/* Shows a display list on the panel, refreshing only the regions that changed
+ * since the last refresh. Partial refreshes leave a faint ghost of the old
+ * image behind, so a full refresh is done every FULL_REFRESH_INTERVAL
+ * refreshes, when more than FULL_REFRESH_AREA percent of the panel changed,
+ * after a reset and on panels without a fast partial update.
+ *
+ * Full refreshes use the fast waveform unless the panel is colder than
+ * FAST_REFRESH_MIN_TEMP. Every CLEAN_REFRESH_INTERVAL-th full refresh, any
+ * that changes more than CLEAN_REFRESH_AREA percent of the panel, and the
+ * first one after a reset, use the normal waveform to clear the ghosting.
+ */
+static void updatePanel(const DisplayList &list) {
+  unsigned long start = millis();
+  // the stored frame is compared against, it must show the clock the panel
+  // shows, see refreshClock()
+  if (clockState.valid
+      && strcmp(clockState.panelText, clockState.frameText) != 0) {
+    DisplayList clock(DISP_WIDTH, DISP_HEIGHT, 16);
+    recordClock(clock, clockState, clockState.panelText);
+    if (framePatch(clock, clockState.box)) {
+      strcpy(clockState.frameText, clockState.panelText);
+    }
+  }
+  if (&list == &displayList) {
+    clockState = nextClock;
+  }
+
+  // every partial refresh runs a whole waveform, however small its window is,
+  // so refreshing more than two windows takes as long as a full refresh
+  const size_t maxRects = 2;
+  std::vector<frame_rect_t> rects;
+  bool compared = frameDiff(list, display.pageHeight(), maxRects, rects);
+  uint32_t area = 0;
+  for (const frame_rect_t &r : rects) {
+    area += r.w * r.h;
+  }
+  if (compared && area == 0) {
+    return; // nothing changed
+  }
+
+  bool partial = compared && display.epd2.hasFastPartialUpdate
+                 && framePartialRefreshes() + 1 < FULL_REFRESH_INTERVAL
+                 && area * 100 <= FULL_REFRESH_AREA * DISP_WIDTH * DISP_HEIGHT;
+  if (partial) {
+    for (const frame_rect_t &r : rects) {
+      restorePrevious(r);
+      replayFrame(list, display, &r);
+    }
+    frameSave(false);
+#if CACHE_WIDGETS
+    widgetCacheSave(&list == &displayList ? &list : nullptr, backgroundEnd);
+#endif
+    lastRefreshMode = REFRESH_PARTIAL;
+  } else {
+    // NAN (no sensor) compares false, the fast waveform is used then
+    bool fast = compared && !(panelTemperature < FAST_REFRESH_MIN_TEMP)
+                && fastRefreshes + 1 < CLEAN_REFRESH_INTERVAL
+                && area * 100 <= CLEAN_REFRESH_AREA * DISP_WIDTH * DISP_HEIGHT;
+    fast = setFastFullRefresh(fast);
+    replayFrame(list, display);
+    frameSave(true);
+#if CACHE_WIDGETS
+    widgetCacheSave(&list == &displayList ? &list : nullptr, backgroundEnd);
+#endif
+    fastRefreshes = fast ? fastRefreshes + 1 : 0;
+    lastRefreshMode = fast ? REFRESH_FAST : REFRESH_FULL;
+  }
+  lastRefreshMillis = millis() - start;
+  return;
+} // end updatePanel
+
+/* Updates the clock on the panel to the time in timeInfo, refreshing only its
+ * box with a partial refresh. The stored frame is left as it is, it is brought
+ * up to date by the next refresh of a whole frame, see updatePanel(). Returns
+ * false if the panel shows no clock. The display must be initialized.
+ */
+bool refreshClock(const tm &timeInfo) {
+  if (!clockState.valid || !display.epd2.hasFastPartialUpdate) {
+    return false;
+  }
+  char text[sizeof(clockState.panelText)];
+  _strftime(text, sizeof(text), TIME_FORMAT, &timeInfo);
+  if (strcmp(text, clockState.panelText) == 0) {
+    return true;
+  }
+  const frame_rect_t &r = clockState.box;
+  DisplayList clock(DISP_WIDTH, DISP_HEIGHT, 16);
+
+  // the controller's previous image is the time on the panel, see
+  // restorePrevious()
+  recordClock(clock, clockState, clockState.panelText);
+  FrameBand band(DISP_WIDTH, DISP_HEIGHT, r.h);
+  band.setTop(r.y);
+  band.fillScreen(GxEPD_WHITE);
+  band.replay(clock);
+  size_t rowBytes = (DISP_WIDTH + 7) / 8;
+  size_t wb = r.w / 8;
+  std::vector<uint8_t> buf(wb * r.h);
+  for (int16_t y = 0; y < r.h; ++y) {
+    memcpy(&buf[y * wb], band.buffer() + y * rowBytes + r.x / 8, wb);
+  }
+  display.epd2.writeImageAgain(buf.data(), r.x, r.y, r.w, r.h);
+
+  clock.clear();
+  recordClock(clock, clockState, text);
+  replayFrame(clock, display, &r);
+  strcpy(clockState.panelText, text);
+  return true;
+} // end refreshClock
+
+/* Returns true if the panel shows a clock, which refreshClock() can update.
+ */
+bool displayShowsClock() { return clockState.valid; }
+
+/* Returns true if the calling task's frame looks the same as the one on the
+ * panel, apart from its volatile regions, see frameUnchanged(). The display
+ * need not be initialized.
+ */
+bool displayUnchanged() {
+  return frameUnchanged(renderTarget(), display.pageHeight());
+} // end displayUnchanged
+
+/* Shows the calling task's frame on the panel, see updatePanel(), and returns
+ * once the refresh has completed. temperature is the indoor temperature
+ * (Celsius), or NAN if unknown.
+ */
+void refreshDisplay(float temperature) {
+  panelTemperature = temperature;
+  updatePanel(renderTarget());
+  return;
+} // end refreshDisplay
+
+// background panel refresh started by refreshDisplayAsync()
+static TaskHandle_t refreshTask = nullptr;
+static SemaphoreHandle_t refreshDoneSem = nullptr;
+
+/* Shows the frame on the panel and waits for the refresh to complete, then
+ * signals waitRefreshDone().
+ */
+static void refreshTaskFn(void *list) {
+  updatePanel(*static_cast<const DisplayList *>(list));
+  xSemaphoreGive(refreshDoneSem);
+  vTaskDelete(nullptr);
+} // end refreshTaskFn
+
+/* Same as refreshDisplay(), but the frame is drawn and the panel updated in
+ * a background task, so the caller can do other work while the panel
+ * refreshes. waitRefreshDone() must be called before the display is touched
+ * again, and nothing may be drawn until then as the background task is still
+ * reading the display list.
+ */
+void refreshDisplayAsync(float temperature) {
+  panelTemperature = temperature;
+  if (refreshDoneSem == nullptr) {
+    refreshDoneSem = xSemaphoreCreateBinary();
+  }
+  DisplayList *list = &renderTarget();
+  // the main loop task runs on the other core, so they don't compete
+  BaseType_t ok = xTaskCreatePinnedToCore(refreshTaskFn, "epd_refresh", 4096,
+                                          list, 1, &refreshTask, 0);
+  if (ok != pdPASS) {
+    refreshTask = nullptr;
+    updatePanel(*list);
+  }
+  return;
+} // end refreshDisplayAsync
+
+/* Blocks until a refresh started by refreshDisplayAsync() has completed. Returns
+ * immediately if there is none in progress.
+ */
+void waitRefreshDone() {
+  if (refreshTask == nullptr) {
+    return;
+  }
+  xSemaphoreTake(refreshDoneSem, portMAX_DELAY);
+  refreshTask = nullptr;
+  return;
+} // end waitRefreshDone
+
 /* Power-off e-paper display
  */
 void powerOffDisplay() {
+  waitRefreshDone();
   display.hibernate(); // turns powerOff() and sets controller to deep sleep for
                        // minimum power use
+  detachInterrupt(PIN_EPD_BUSY);
   digitalWrite(PIN_EPD_PWR, LOW);
   return;
 } // end initDisplay
 
+/* Draws the parts of the weather screen that do not depend on the data: the
+ * indoor icons and the bars between the forecast highs and lows. Called right
+ * after beginFrame(). The firmware's frame copies them from RTC memory after
+ * the first frame since the last reset.
+ */
+void drawBackground() {
+  DisplayList &gfx = renderTarget();
+  if (&gfx == &displayList && backgroundSize > 0) {
+    for (uint8_t i = 0; i < backgroundSize; ++i) {
+      gfx.append(backgroundCalls[i]);
+    }
+    backgroundEnd = gfx.size();
+    return;
+  }
+  size_t first = gfx.size();
+
+  const dl_rect_t &indoorTemp = LAYOUT[LAYOUT_INDOOR_TEMP].box;
+  const dl_rect_t &indoorHumidity = LAYOUT[LAYOUT_INDOOR_HUMIDITY].box;
+  gfx.drawInvertedBitmap(indoorTemp.x + indoorTempOffset,
+                         layoutCenterY(indoorTemp) - 48 / 2,
+                         house_thermometer_48x48, 48, 48, GxEPD_BLACK);
+  gfx.drawInvertedBitmap(indoorHumidity.x,
+                         layoutCenterY(indoorHumidity) - 48 / 2,
+                         house_humidity_48x48, 48, 48, GxEPD_BLACK);
+
+  const dl_rect_t &forecast = LAYOUT[LAYOUT_FORECAST].box;
+  gfx.setFont(&FONT_8pt8b);
+  for (int i = 0; i < LAYOUT_FORECAST_DAYS; ++i) {
+    const dl_rect_t day = layoutColumn(forecast, i, LAYOUT_FORECAST_DAYS);
+    drawString(layoutCenterX(day), day.y + 116, "|", CENTER);
+  }
+
+  if (&gfx == &displayList && gfx.size() - first <= BACKGROUND_CALLS) {
+    backgroundSize = 0;
+    for (size_t i = first; i < gfx.size(); ++i) {
+      backgroundCalls[backgroundSize++] = gfx.op(i);
+    }
+    backgroundEnd = gfx.size();
+  }
+  return;
+} // end drawBackground
+
 void drawCurrentConditions(const dwd_current_t &current,
                            const dwd_daily_t &today, float inTemp,
                            float inHumidity) {
+  DisplayList &gfx = renderTarget();
   String dataStr, unitStr;
 
   // ########## Weather Icon ##########
-  // (0,0) (196,196)
-  // debug
-  // display.drawRect(0, 0, 196, 196, 0);
-
-  display.drawInvertedBitmap(0, 0,
+  const dl_rect_t &icon = LAYOUT[LAYOUT_CURRENT_ICON].box;
+  gfx.drawInvertedBitmap(icon.x, icon.y,
                              getCurrentConditionsBitmap196(current, today), 196,
                              196, GxEPD_BLACK);
 
   // ########## current temp ##########
-  // debug
-  // display.drawRect(196, 0, 164, 140, 0);
-
+  const layout_widget_t &temp = LAYOUT[LAYOUT_CURRENT_TEMP];
   dataStr = String(static_cast<int>(std::round(current.condition.temperatur)));
   unitStr = TXT_UNITS_TEMP_CELSIUS;
   const int unit_offset = 20;
 
-  // temperatur
-  display.setFont(&FONT_48pt8b_temperature);
-  drawString(196 + (164 / 2) - unit_offset, (140 / 2) + (48 / 2) + 15, dataStr,
-             CENTER);
+  // temperatur, centered with room for the unit on its right
+  const int tempBaseline = layoutCenterY(temp.box) + (48 / 2) + 15;
+  setLayoutFont(temp);
+  drawString(layoutCenterX(temp.box) - unit_offset, tempBaseline, dataStr,
+             temp.align);
 
-  // unit
-  display.setFont(&FONT_14pt8b);
-  drawString(display.getCursorX(), (196 / 2) - (140 / 2) + (48 / 2) - 10 + 15,
-             unitStr, LEFT);
+  // unit, raised to the top of the digits
+  gfx.setFont(&FONT_14pt8b);
+  drawString(gfx.getCursorX(), tempBaseline - 52, unitStr, LEFT);
 
   // ########## INDOR DATA ##########
-  // debug
-  // display.drawRect(196, 140, 82, 56, 0);
-
-  const int temperatur_offset = -4;
-
-  display.drawInvertedBitmap(196 + temperatur_offset, 140 + ((56 - 48) / 2),
-                             house_thermometer_48x48, 48, 48, GxEPD_BLACK);
-
-  // debug
-  // display.drawRect(196 + 82, 140, 82, 56, 0);
-
-  display.drawInvertedBitmap(196 + 82, 140 + ((56 - 48) / 2),
-                             house_humidity_48x48, 48, 48, GxEPD_BLACK);
+  const layout_widget_t &indoorTemp = LAYOUT[LAYOUT_INDOOR_TEMP];
+  const layout_widget_t &indoorHumidity = LAYOUT[LAYOUT_INDOOR_HUMIDITY];
+  // both are in the same row
+  const int indoorY = layoutCenterY(indoorTemp.box);
 
   // temperatur
-  display.setFont(&FONT_12pt8b);
   if (!std::isnan(inTemp)) {
     dataStr = String(static_cast<int>(std::round(inTemp)));
   } else {
@@ -263,71 +709,112 @@ void drawCurrentConditions(const dwd_current_t &current,
   }
 
   dataStr += "\260"; // dagree
-  drawString(196 + 48 + temperatur_offset, 140 + (56 / 2) + (12 / 2), dataStr,
-             LEFT);
+  uint32_t hash = WidgetHash().add(dataStr).value();
+  if (!drawCachedWidget(WIDGET_INDOOR_TEMP, hash)) {
+    size_t first = gfx.size();
+    setLayoutFont(indoorTemp);
+    drawString(indoorTemp.box.x + 48 + indoorTempOffset, indoorY + (12 / 2),
+               dataStr, indoorTemp.align);
+    addCachedWidget(WIDGET_INDOOR_TEMP, hash, first);
+  }
 
   // humidity
-  display.setFont(&FONT_12pt8b);
   if (!std::isnan(inHumidity)) {
     dataStr = String(static_cast<int>(std::round(inHumidity)));
   } else {
     dataStr = "--";
   }
 
-  drawString(196 + 82 + 48, 140 + (56 / 2) + (12 / 2), dataStr, LEFT);
-  display.setFont(&FONT_8pt8b);
-  drawString(display.getCursorX(), 140 + (56 / 2) + 5, "%", LEFT);
+  hash = WidgetHash().add(dataStr).value();
+  if (!drawCachedWidget(WIDGET_INDOOR_HUMIDITY, hash)) {
+    size_t first = gfx.size();
+    setLayoutFont(indoorHumidity);
+    drawString(indoorHumidity.box.x + 48, indoorY + (12 / 2), dataStr,
+               indoorHumidity.align);
+    gfx.setFont(&FONT_8pt8b);
+    drawString(gfx.getCursorX(), indoorY + 5, "%", LEFT);
+    addCachedWidget(WIDGET_INDOOR_HUMIDITY, hash, first);
+  }
   return;
 }
 
-/* This function is responsible for drawing the five day forecast.
+/* Draws the forecast of one day into its column of the forecast.
  */
-void drawForecast(const dwd_daily_t *daily, tm timeInfo) {
-  // 5 day, forecast
+static void drawForecastDay(const dwd_daily_t &daily, const tm &timeInfo,
+                            const dl_rect_t &day) {
+  DisplayList &gfx = renderTarget();
+  const layout_widget_t &forecast = LAYOUT[LAYOUT_FORECAST];
   String hiStr, loStr;
   String dataStr, unitStr;
-  for (int i = 0; i < 5; ++i) {
-    int x = 398 + (i * 82);
-    // icons
-    display.drawInvertedBitmap(x, 98 + 69 / 2 - 32 - 6,
-                               getDailyForecastBitmap64(daily[i]), 64, 64,
-                               GxEPD_BLACK);
-    // day of week label
-    display.setFont(&FONT_11pt8b);
-    char dayBuffer[8] = {};
-    _strftime(dayBuffer, sizeof(dayBuffer), "%a", &timeInfo); // abbrv'd day
-    drawString(x + 31 - 2, 98 + 69 / 2 - 32 - 26 - 6 + 16, dayBuffer, CENTER);
-    timeInfo.tm_wday = (timeInfo.tm_wday + 1) % 7; // increment to next day
-
-    // high | low
-    display.setFont(&FONT_8pt8b);
-    drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 12, "|", CENTER);
-    hiStr = String(static_cast<int>(std::round(daily[i].temp_max))) + "\260";
-    loStr = String(static_cast<int>(std::round(daily[i].temp_min))) + "\260";
-    drawString(x + 31 - 4, 98 + 69 / 2 + 38 - 6 + 12, hiStr, RIGHT);
-    drawString(x + 31 + 5, 98 + 69 / 2 + 38 - 6 + 12, loStr, LEFT);
+  int x = layoutCenterX(day);
+  // icons
+  gfx.drawInvertedBitmap(x - 31, day.y + 34, getDailyForecastBitmap64(daily),
+                             64, 64, GxEPD_BLACK);
+  // day of week label
+  setLayoutFont(forecast);
+  char dayBuffer[8] = {};
+  _strftime(dayBuffer, sizeof(dayBuffer), "%a", &timeInfo); // abbrv'd day
+  drawString(x - 2, day.y + 24, dayBuffer, forecast.align);
+
+  // high | low, the bar is part of the background
+  gfx.setFont(&FONT_8pt8b);
+  hiStr = String(static_cast<int>(std::round(daily.temp_max))) + "\260";
+  loStr = String(static_cast<int>(std::round(daily.temp_min))) + "\260";
+  drawString(x - 4, day.y + 116, hiStr, RIGHT);
+  drawString(x + 5, day.y + 116, loStr, LEFT);
 
 // daily forecast precipitation
 #if DISPLAY_DAILY_PRECIP
-    float dailyPrecip;
+  float dailyPrecip;
 #if defined(UNITS_DAILY_PRECIP_POP)
-    dailyPrecip = daily[i].pop * 100;
-    dataStr = String(static_cast<int>(dailyPrecip));
-    unitStr = "%";
+  dailyPrecip = daily.pop * 100;
+  dataStr = String(static_cast<int>(dailyPrecip));
+  unitStr = "%";
 #else
-    dailyPrecip = daily[i].snow + daily[i].rain;
+  dailyPrecip = daily.snow + daily.rain;
 #if defined(UNITS_DAILY_PRECIP_MILLIMETERS)
-    // Round up to nearest mm
-    dailyPrecip = std::round(dailyPrecip);
-    dataStr = String(static_cast<int>(dailyPrecip));
-    unitStr = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
+  // Round up to nearest mm
+  dailyPrecip = std::round(dailyPrecip);
+  dataStr = String(static_cast<int>(dailyPrecip));
+  unitStr = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
 #endif
-    if (dailyPrecip > 0.0f) {
-      display.setFont(&FONT_6pt8b);
-      drawString(x + 31, 98 + 69 / 2 + 38 - 6 + 26, dataStr + unitStr, CENTER);
-    }
+  if (dailyPrecip > 0.0f) {
+    gfx.setFont(&FONT_6pt8b);
+    drawString(x, day.y + 130, dataStr + unitStr, CENTER);
+  }
 #endif
 #endif // DISPLAY_DAILY_PRECIP
+  return;
+} // end drawForecastDay
+
+/* This function is responsible for drawing the five day forecast. Days whose
+ * forecast has not changed are copied from the panel, see drawCachedWidget().
+ */
+void drawForecast(const dwd_daily_t *daily, tm timeInfo) {
+  // 5 day, forecast
+  const layout_widget_t &forecast = LAYOUT[LAYOUT_FORECAST];
+  for (int i = 0; i < LAYOUT_FORECAST_DAYS; ++i) {
+    const dl_rect_t day = layoutColumn(forecast.box, i, LAYOUT_FORECAST_DAYS);
+    widget_cache_slot_t slot =
+        static_cast<widget_cache_slot_t>(WIDGET_FORECAST + i);
+    uint32_t hash = WidgetHash()
+                        .add(static_cast<uint32_t>(timeInfo.tm_wday))
+                        .add(static_cast<uint32_t>(daily[i].icon))
+                        .add(daily[i].temp_max)
+                        .add(daily[i].temp_min)
+                        .add(daily[i].pop)
+                        .add(daily[i].snow)
+                        .add(daily[i].rain)
+                        .add(daily[i].clouds)
+                        .add(daily[i].wind_speed)
+                        .add(daily[i].wind_gust)
+                        .value();
+    if (!drawCachedWidget(slot, hash)) {
+      size_t first = renderTarget().size();
+      drawForecastDay(daily[i], timeInfo, day);
+      addCachedWidget(slot, hash, first);
+    }
+    timeInfo.tm_wday = (timeInfo.tm_wday + 1) % 7; // increment to next day
   }
 
   return;
@@ -337,76 +824,152 @@ void drawForecast(const dwd_daily_t *daily, tm timeInfo) {
  * information in the top right corner.
  */
 void drawLocationDate(const String &city, const String &date) {
+  DisplayList &gfx = renderTarget();
+  const layout_widget_t &header = LAYOUT[LAYOUT_HEADER];
+  const int16_t x = layoutRight(header.box) - 2;
+  // the clock is drawn left of it, see drawClock()
+  uint32_t hash = WidgetHash().add(city).add(date).value();
+  if (drawCachedWidget(WIDGET_LOCATION, hash, locationLeft)) {
+    return;
+  }
+  size_t first = gfx.size();
   // location, date
-  display.setFont(&FONT_16pt8b);
-  drawString(DISP_WIDTH - 2, 23, city, RIGHT, ACCENT_COLOR);
-  display.setFont(&FONT_12pt8b);
-  drawString(DISP_WIDTH - 2, 30 + 4 + 17, date, RIGHT);
+  setLayoutFont(header);
+  uint16_t w = getStringWidth(city);
+  drawString(x, header.box.y + 23, city, header.align, ACCENT_COLOR);
+  gfx.setFont(&FONT_12pt8b);
+  w = std::max(w, getStringWidth(date));
+  drawString(x, header.box.y + 30 + 4 + 17, date, header.align);
+  locationLeft = x - w;
+  addCachedWidget(WIDGET_LOCATION, hash, first, locationLeft);
   return;
 } // end drawLocationDate
 
-/* The % operator in C++ is not a true modulo operator but it instead a
- * remainder operator. The remainder operator and modulo operator are equivalent
- * for positive numbers, but not for negatives. The follow implementation of the
- * modulo operator works for +/-a and +b.
- */
-inline int modulo(int a, int b) {
-  const int result = a % b;
-  return result >= 0 ? result : result + b;
-}
-
-/* Convert temperature in celsius to the display y coordinate to be plotted.
+/* Draws the time, formatted with TIME_FORMAT, left of the location and date.
+ * Minute wakes update it with a partial refresh of its box, see
+ * refreshClock(). The box fits every time of day so that the clock never
+ * moves or grows into its neighbours, and it is a volatile region, so that
+ * the time alone never makes the panel refresh.
  */
-int temperatur_to_plot_y(float temperatur, int tempBoundMin, float yPxPerUnit,
-                         int yBoundMin) {
-  return static_cast<int>(
-      std::round(yBoundMin - (yPxPerUnit * (temperatur - tempBoundMin))));
-}
+void drawClock(const tm &timeInfo) {
+  DisplayList &gfx = renderTarget();
+  clock_state_t clock = {};
+  clock.valid = true;
+  clock.x = locationLeft - 16;
+  clock.y = LAYOUT[LAYOUT_HEADER].box.y + 30 + 4 + 17; // the date's baseline
+  gfx.setFont(&FONT_26pt8b);
+
+  char text[sizeof(clock.panelText)];
+  int16_t x0 = INT16_MAX, y0 = INT16_MAX, x1 = INT16_MIN, y1 = INT16_MIN;
+  tm t = timeInfo;
+  for (t.tm_hour = 0; t.tm_hour < 24; ++t.tm_hour) {
+    for (t.tm_min = 0; t.tm_min < 60; ++t.tm_min) {
+      _strftime(text, sizeof(text), TIME_FORMAT, &t);
+      int16_t bx, by;
+      uint16_t bw, bh;
+      gfx.getTextBounds(text, 0, clock.y, &bx, &by, &bw, &bh);
+      // right aligned, see drawString()
+      x0 = std::min<int16_t>(x0, clock.x - bw + bx);
+      x1 = std::max<int16_t>(x1, clock.x + bx);
+      y0 = std::min(y0, by);
+      y1 = std::max<int16_t>(y1, by + bh);
+    }
+  }
+  x0 = std::max<int16_t>(x0, 0) & ~7;
+  x1 = std::min<int16_t>((x1 + 7) & ~7, DISP_WIDTH);
+  clock.box = {x0, y0, static_cast<int16_t>(x1 - x0),
+               static_cast<int16_t>(y1 - y0)};
+
+  _strftime(clock.panelText, sizeof(clock.panelText), TIME_FORMAT, &timeInfo);
+  strcpy(clock.frameText, clock.panelText);
+  recordClock(gfx, clock, clock.panelText);
+  gfx.markVolatile(clock.box.x, clock.box.y, clock.box.w, clock.box.h);
+  if (&gfx == &displayList) {
+    nextClock = clock;
+  }
+  return;
+} // end drawClock
 
 void printTime2(tm &timeInfo) {
   Serial.printf("Time: %i-%i-%iT%i:%i\n", timeInfo.tm_year + 1900, timeInfo.tm_mon + 1, timeInfo.tm_mday, timeInfo.tm_hour, timeInfo.tm_min);
 }
 
+/* Returns the hourly precipitation in the units the graph is labeled in.
+ */
+static float hourlyPrecip(const dwd_hourly_t &hour) {
+#ifdef UNITS_HOURLY_PRECIP_POP
+  return hour.precipitation_probability;
+#elif defined(UNITS_HOURLY_PRECIP_CENTIMETERS)
+  return millimeters_to_centimeters(hour.precipitation);
+#elif defined(UNITS_HOURLY_PRECIP_INCHES)
+  return millimeters_to_inches(hour.precipitation);
+#else
+  return hour.precipitation;
+#endif
+} // end hourlyPrecip
+
+/* Returns the value of an axis at grid line tick, counted from the top.
+ */
+static String axisLabel(const chart_axis_t &axis, uint8_t tick) {
+  float value = axis.max - tick * axis.step;
+  if (axis.decimals == 0) {
+    return String(static_cast<int>(std::round(value)));
+  }
+  return String(value, static_cast<unsigned int>(axis.decimals));
+} // end axisLabel
+
+#if DISPLAY_HOURLY_PRESSURE || DISPLAY_HOURLY_HUMIDITY || DISPLAY_HOURLY_WIND
+/* Adds an hourly series drawn as a thin line, scaled to fit the graph on an
+ * axis of its own that is not labeled.
+ */
+static void addHourlyLine(Chart &chart, const dwd_hourly_t *hourly,
+                          float *values, float (*value)(const dwd_hourly_t &),
+                          float minStep, bool fromZero) {
+  chart_series_t *series = chart.addSeries(chartLine, GxEPD_BLACK);
+  if (series == nullptr) {
+    return;
+  }
+  for (uint16_t i = 0; i < chart.samples(); ++i) {
+    values[i] = value(hourly[i]);
+  }
+  chart.setValues(*series, values, CHART_LTTB);
+  series->axis = niceAxis(fromZero ? 0 : series->lo, series->hi,
+                          chart.ticks(), minStep);
+  return;
+} // end addHourlyLine
+#endif
+
 /* This function is responsible for drawing the outlook graph for the specified
- * number of hours(up to 48).
+ * number of hours(up to 96). Longer outlooks are drawn with no more points
+ * than shorter ones, see Chart::setValues().
  */
 void drawOutlookGraph(const dwd_hourly_t *hourly, const dwd_daily_t *daily,
                       tm timeInfo) {
+  DisplayList &gfx = renderTarget();
+  const layout_widget_t &outlook = LAYOUT[LAYOUT_OUTLOOK];
 
   // offset to current time
   hourly += timeInfo.tm_hour;
   // auto hourly_off = hourly + std::max(0,timeInfo.tm_hour);
   Serial.printf("\nCurrent HOUR = %d\n\n", timeInfo.tm_hour);
 
-  const int xPos0 = 50;
-  int xPos1 = DISP_WIDTH;
-  const int yPos0 = 216;
-  const int yPos1 = DISP_HEIGHT - 46;
+  // the plot, inside the room for the axis labels
+  const int xPos0 = outlook.box.x + 50;
+  int xPos1 = layoutRight(outlook.box);
+  const int yPos0 = outlook.box.y + 20;
+  const int yPos1 = layoutBottom(outlook.box) - 24;
 
   // Graph format
   int yMajorTicks = 5;
-  int yTempMajorTicks = 5;
-  int xMaxTicks = 12;
+  const int xMaxTicks = 12;
+  // as many as there are left after the current hour
+  const int hours =
+      std::min(HOURLY_GRAPH_MAX, DWD_NUM_DAILY * DWD_DAYS - timeInfo.tm_hour);
+  float values[DWD_NUM_DAILY * DWD_DAYS];
 
-  // calculate y max/min and intervals
-  float tempMin = hourly[0].temperatur;
-  float tempMax = tempMin;
-#ifdef UNITS_HOURLY_PRECIP_POP
-  float precipMax = hourly[0].precipitation_probability;
-#else
-  float precipMax = hourly[0].precipitation;
-#endif
-  float newTemp = 0;
-
-  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i) {
-    newTemp = hourly[i].temperatur;
-    tempMin = std::min(tempMin, newTemp);
-    tempMax = std::max(tempMax, newTemp);
-#ifdef UNITS_HOURLY_PRECIP_POP
-    precipMax = std::max<float>(precipMax, hourly[i].precipitation_probability);
-#else
-    precipMax = std::max<float>(precipMax, hourly[i].precipitation);
-#endif
+  float precipMax = 0;
+  for (int i = 0; i < hours; ++i) {
+    precipMax = std::max(precipMax, hourlyPrecip(hourly[i]));
 
     Serial.printf("Temperatur: %f \t Precipitation: %f \t",hourly[i].temperatur, hourly[i].precipitation);
     Serial.printf("Time: %i-%i-%iT%i:%i\n", hourly[i].time.tm_year + 1900,
@@ -416,240 +979,162 @@ void drawOutlookGraph(const dwd_hourly_t *hourly, const dwd_daily_t *daily,
 
   Serial.printf("MaxPrecipitation: %f \n", precipMax);
 
-  int tempBoundMin = static_cast<int>(tempMin - 1) -
-                     modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
-  int tempBoundMax = static_cast<int>(tempMax + 1) +
-                     (yTempMajorTicks -
-                      modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
-
-  // while we have to many major ticks then increase the step
-  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks > yMajorTicks) {
-    yTempMajorTicks += 5;
-    tempBoundMin = static_cast<int>(tempMin - 1) -
-                   modulo(static_cast<int>(tempMin - 1), yTempMajorTicks);
-    tempBoundMax = static_cast<int>(tempMax + 1) +
-                   (yTempMajorTicks -
-                    modulo(static_cast<int>(tempMax + 1), yTempMajorTicks));
-  }
-  // while we have not enough major ticks, add to either bound
-  while ((tempBoundMax - tempBoundMin) / yTempMajorTicks < yMajorTicks) {
-    // add to whatever bound is closer to the actual min/max
-    if (tempMin - tempBoundMin <= tempBoundMax - tempMax) {
-      tempBoundMin -= yTempMajorTicks;
-    } else {
-      tempBoundMax += yTempMajorTicks;
-    }
-  }
-
 #ifdef UNITS_HOURLY_PRECIP_POP
-  xPos1 = DISP_WIDTH - 23;
-  float precipBoundMax;
-  if (precipMax > 0) {
-    precipBoundMax = 100.0f;
-  } else {
-    precipBoundMax = 0.0f;
-  }
+  xPos1 -= 23;
+  String precipUnit = "%";
 #else
+  xPos1 -= 24;
 #ifdef UNITS_HOURLY_PRECIP_MILLIMETERS
-  xPos1 = DISP_WIDTH - 24;
-  float precipBoundMax = std::ceil(precipMax); // Round up to nearest mm
-  int yPrecipMajorTickDecimals = (precipBoundMax < 10);
+  String precipUnit = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
+  // ensure that the scaling is not missleading
+  const float precipMinRange = 3.0f;
+#elif defined(UNITS_HOURLY_PRECIP_CENTIMETERS)
+  String precipUnit = String(" ") + TXT_UNITS_PRECIP_CENTIMETERS;
+  const float precipMinRange = 0.3f;
+#else
+  String precipUnit = String(" ") + TXT_UNITS_PRECIP_INCHES;
+  const float precipMinRange = 0.1f;
 #endif
-  float yPrecipMajorTickValue = precipBoundMax / yMajorTicks;
-  float precipRoundingMultiplier = std::pow(10.f, yPrecipMajorTickDecimals);
 #endif
 
-  if (precipBoundMax > 0) { // fill need extra room for labels
+  // there is no scale to draw precipitation against if it is all 0
+  bool showPrecip = precipMax > 0;
+  if (showPrecip) { // fill need extra room for labels
     xPos1 -= 23;
   }
 
-  // ensure that the scaling is not missleading
-  if ( precipBoundMax > 0 && precipBoundMax < 3.0f) {
-    precipBoundMax = 3.0f;
-  }
-
-  // draw x axis
-  display.drawLine(xPos0, yPos1, xPos1, yPos1, GxEPD_BLACK);
-  display.drawLine(xPos0, yPos1 - 1, xPos1, yPos1 - 1, GxEPD_BLACK);
+  Chart chart(xPos0, yPos0, xPos1, yPos1, hours, yMajorTicks);
 
-  // draw y axis
-  float yInterval = (yPos1 - yPos0) / static_cast<float>(yMajorTicks);
-  for (int i = 0; i <= yMajorTicks; ++i) {
-    String dataStr;
-    int yTick = static_cast<int>(yPos0 + (i * yInterval));
-    display.setFont(&FONT_8pt8b);
-    // Temperature
-    dataStr = String(tempBoundMax - (i * yTempMajorTicks));
-    dataStr += "\260";
-
-    drawString(xPos0 - 8, yTick + 4, dataStr, RIGHT, ACCENT_COLOR);
-
-    if (precipBoundMax > 0) { // don't labels if precip is 0
+  chart_series_t *precip = nullptr;
+  if (showPrecip) {
+    precip = chart.addSeries(chartHatched, GxEPD_BLACK);
+    for (int i = 0; i < hours; ++i) {
+      values[i] = hourlyPrecip(hourly[i]);
+    }
+    chart.setValues(*precip, values, CHART_MAX);
 #ifdef UNITS_HOURLY_PRECIP_POP
-                              // PoP
-      dataStr = String(100 - (i * 20));
-      String precipUnit = "%";
+    precip->axis = niceAxis(0, 100, yMajorTicks, 0);
 #else
-                              // Precipitation volume
-      float precipTick = precipBoundMax - (i * yPrecipMajorTickValue);
-      precipTick = std::round(precipTick * precipRoundingMultiplier) /
-                   precipRoundingMultiplier;
-      dataStr = String(precipTick, yPrecipMajorTickDecimals);
-#ifdef UNITS_HOURLY_PRECIP_MILLIMETERS
-      String precipUnit = String(" ") + TXT_UNITS_PRECIP_MILLIMETERS;
+    precip->axis = niceAxis(0, std::max(precipMax, precipMinRange),
+                            yMajorTicks, 0);
 #endif
+  }
+#if DISPLAY_HOURLY_PRESSURE
+  addHourlyLine(
+      chart, hourly, values,
+      [](const dwd_hourly_t &hour) { return hour.pressure_msl; }, 1, false);
+#endif
+#if DISPLAY_HOURLY_HUMIDITY
+  addHourlyLine(
+      chart, hourly, values,
+      [](const dwd_hourly_t &hour) {
+        return static_cast<float>(hour.relative_humidity);
+      },
+      20, true);
+#endif
+#if DISPLAY_HOURLY_WIND
+  addHourlyLine(
+      chart, hourly, values,
+      [](const dwd_hourly_t &hour) { return hour.wind_speed; }, 1, true);
 #endif
 
-      drawString(xPos1 + 8, yTick + 4, dataStr, LEFT);
-      display.setFont(&FONT_5pt8b);
-      drawString(display.getCursorX(), yTick + 4, precipUnit, LEFT);
-    } // end draw labels if precip is >0
-
-    // draw dotted line
-    if (i < yMajorTicks) {
-      for (int x = xPos0; x <= xPos1 + 1; x += 3) {
-        display.drawPixel(x, yTick + (yTick % 2), GxEPD_BLACK);
-      }
-    }
+  // temperature last, on top of everything else
+  chart_series_t *temp = chart.addSeries(chartLine, ACCENT_COLOR, 2);
+  for (int i = 0; i < hours; ++i) {
+    values[i] = hourly[i].temperatur;
   }
+  chart.setValues(*temp, values, CHART_LTTB);
+  temp->axis = niceAxis(temp->lo - 1, temp->hi + 1, yMajorTicks, 1);
 
-  int hourInterval =
-      static_cast<int>(ceil(HOURLY_GRAPH_MAX / static_cast<float>(xMaxTicks)));
-  float xInterval = (xPos1 - xPos0 - 1) / static_cast<float>(HOURLY_GRAPH_MAX);
-  display.setFont(&FONT_8pt8b);
+  chart.layout();
+  chart.draw(gfx);
 
-  // precalculate all x and y coordinates for temperature values
-  float yPxPerUnit =
-      (yPos1 - yPos0) / static_cast<float>(tempBoundMax - tempBoundMin);
-  std::vector<int> x_t;
-  std::vector<int> y_t;
-  x_t.reserve(HOURLY_GRAPH_MAX);
-  y_t.reserve(HOURLY_GRAPH_MAX);
-  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i) {
-    y_t[i] = temperatur_to_plot_y(hourly[i].temperatur, tempBoundMin, yPxPerUnit, yPos1);
-    x_t[i] = static_cast<int>(
-        std::round(xPos0 + (i * xInterval) + (0.5 * xInterval)));
-  }
+  // draw y axis labels
+  for (int i = 0; i <= yMajorTicks; ++i) {
+    int yTick = chart.gridY(i);
+    setLayoutFont(outlook);
+    // Temperature
+    String dataStr = axisLabel(temp->axis, i) + "\260";
+    drawString(xPos0 - 8, yTick + 4, dataStr, RIGHT, ACCENT_COLOR);
 
-#if DISPLAY_HOURLY_ICONS
-  int day_idx = 0;
-#endif
-  display.setFont(&FONT_8pt8b);
-  for (int i = 0; i < HOURLY_GRAPH_MAX; ++i) {
-    int xTick = static_cast<int>(xPos0 + (i * xInterval));
-    int x0_t, x1_t, y0_t, y1_t;
-
-    if (i > 0) {
-      // temperature
-      x0_t = x_t[i - 1];
-      x1_t = x_t[i];
-      y0_t = y_t[i - 1];
-      y1_t = y_t[i];
-      // graph temperature
-      display.drawLine(x0_t, y0_t, x1_t, y1_t, ACCENT_COLOR);
-      display.drawLine(x0_t, y0_t + 1, x1_t, y1_t + 1, ACCENT_COLOR);
-      display.drawLine(x0_t - 1, y0_t, x1_t - 1, y1_t, ACCENT_COLOR);
-
-      // draw hourly bitmap
-#if DISPLAY_HOURLY_ICONS
-      if (daily[day_idx].time.tm_mday != hourly[i].time.tm_mday) {
-        ++day_idx;
-      }
-
-      if ((i % hourInterval) == 0) // skip first and last tick
-      {
-        int y_b = INT_MAX;
-        // find the highest (lowest in coordinate value) temperature point that
-        // exists within the width of the icon.
-        // find closest point above the temperature line where the icon won't
-        // interect the temperature line.
-        // y = mx + b
-        int span = static_cast<int>(std::round(16 / xInterval));
-        int l_idx = std::max(i - 1 - span, 0);
-        int r_idx = std::min(i + span, HOURLY_GRAPH_MAX - 1);
-        // left intersecting slope
-        float m_l = (y_t[l_idx + 1] - y_t[l_idx]) / xInterval;
-        int x_l = xTick - 16 - x_t[l_idx];
-        int y_l = static_cast<int>(std::round(m_l * x_l + y_t[l_idx]));
-        y_b = std::min(y_l, y_b);
-        // right intersecting slope
-        float m_r = (y_t[r_idx] - y_t[r_idx - 1]) / xInterval;
-        int x_r = xTick + 16 - x_t[r_idx - 1];
-        int y_r = static_cast<int>(std::round(m_r * x_r + y_t[r_idx - 1]));
-        y_b = std::min(y_r, y_b);
-        // any peaks in between
-        for (int idx = l_idx + 1; idx < r_idx; ++idx) {
-          y_b = std::min(y_t[idx], y_b);
-        }
-        const uint8_t *bitmap =
-            getHourlyForecastBitmap32(hourly[i], daily[day_idx]);
-        display.drawInvertedBitmap(xTick - 16, y_b - 32, bitmap, 32, 32,
-                                   GxEPD_BLACK);
-      }
-#endif
+    if (precip) { // don't labels if precip is 0
+      drawString(xPos1 + 8, yTick + 4, axisLabel(precip->axis, i), LEFT);
+      gfx.setFont(&FONT_5pt8b);
+      drawString(gfx.getCursorX(), yTick + 4, precipUnit, LEFT);
     }
+  }
 
-#ifdef UNITS_HOURLY_PRECIP_POP
-    float precipVal = hourly[i].precipitation_probability;
-#else
-    float precipVal = hourly[i].precipitation;
-#ifdef UNITS_HOURLY_PRECIP_CENTIMETERS
-    precipVal = millimeters_to_centimeters(precipVal);
-#endif
-#endif
+  int hourInterval = static_cast<int>(ceil(hours / static_cast<float>(xMaxTicks)));
 
-    x0_t = static_cast<int>(std::round(xPos0 + 1 + (i * xInterval)));
-    x1_t = static_cast<int>(std::round(xPos0 + 1 + ((i + 1) * xInterval)));
-    yPxPerUnit = (yPos1 - yPos0) / precipBoundMax;
-    y0_t = static_cast<int>(std::round(yPos1 - (yPxPerUnit * (precipVal))));
-    y1_t = yPos1;
-
-    // graph Precipitation
-    for (int y = y1_t - 1; y > y0_t; y -= 2) {
-      for (int x = x0_t + (x0_t % 2); x < x1_t; x += 2) {
-        display.drawPixel(x, y, GxEPD_BLACK);
-      }
+#if DISPLAY_HOURLY_ICONS
+  // one at each tick, the chart leaves out those that do not fit
+  chart_mark_t icons[xMaxTicks];
+  uint8_t iconCount = 0;
+  for (int i = 0; i < hours; i += hourInterval) {
+    icons[iconCount++] = {static_cast<uint16_t>(i), 0, 0};
+  }
+  // icons may reach up to the daily forecast, half an icon above the graph
+  chart.placeMarks(*temp, icons, iconCount, 32, 32, yPos0 - 16);
+  int day_idx = 0;
+  for (uint8_t n = 0; n < iconCount; ++n) {
+    const chart_mark_t &icon = icons[n];
+    if (icon.y == INT16_MAX) {
+      continue;
     }
-
-    if ((i % hourInterval) == 0) {
-      // draw x tick marks
-      display.drawLine(xTick, yPos1 + 1, xTick, yPos1 + 4, GxEPD_BLACK);
-      display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
-      // draw x axis labels
-      char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
-      tm timeInfo = hourly[i].time;
-      _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, &timeInfo);
-      drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
+    const dwd_hourly_t &hour = hourly[icon.sample];
+    while (day_idx + 1 < DWD_DAYS
+           && daily[day_idx].time.tm_mday != hour.time.tm_mday) {
+      ++day_idx;
     }
+    const uint8_t *bitmap = getHourlyForecastBitmap32(hour, daily[day_idx]);
+    gfx.drawInvertedBitmap(icon.x, icon.y, bitmap, 32, 32, GxEPD_BLACK);
   }
+#endif
+
+  setLayoutFont(outlook);
+  for (int i = 0; i <= hours; i += hourInterval) {
+    int xTick = chart.tickX(i);
 
-  // draw the last tick mark
-  if ((HOURLY_GRAPH_MAX % hourInterval) == 0) {
-    int xTick =
-        static_cast<int>(std::round(xPos0 + (HOURLY_GRAPH_MAX * xInterval)));
     // draw x tick marks
-    display.drawLine(xTick, yPos1 + 1, xTick, yPos1 + 4, GxEPD_BLACK);
-    display.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
-    // draw x axis labels
+    gfx.drawLine(xTick, yPos1 + 1, xTick, yPos1 + 4, GxEPD_BLACK);
+    gfx.drawLine(xTick + 1, yPos1 + 1, xTick + 1, yPos1 + 4, GxEPD_BLACK);
+    // draw x axis labels, the last tick is the end of the last hour
     char timeBuffer[12] = {}; // big enough to accommodate "hh:mm:ss am"
-    tm timeInfo = hourly[HOURLY_GRAPH_MAX - 1].time;
-    timeInfo.tm_hour += 1;
+    tm timeInfo = hourly[std::min(i, hours - 1)].time;
+    if (i == hours) {
+      timeInfo.tm_hour += 1;
+    }
     _strftime(timeBuffer, sizeof(timeBuffer), HOUR_FORMAT, &timeInfo);
-    drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, CENTER);
+    drawString(xTick, yPos1 + 1 + 12 + 4 + 3, timeBuffer, outlook.align);
   }
 
   return;
 } // end drawOutlookGraph
 
+/* Marks a status bar item, from its icon at x0 to its right aligned text
+ * ending at x1, as volatile, see DisplayList::markVolatile().
+ */
+static void markStatusVolatile(int16_t x0, int16_t x1) {
+  DisplayList &gfx = renderTarget();
+  const dl_rect_t &bar = LAYOUT[LAYOUT_STATUS_BAR].box;
+  gfx.markVolatile(x0, bar.y, x1 - x0, bar.h);
+  return;
+} // end markStatusVolatile
+
 /* This function is responsible for drawing the status bar along the bottom of
  * the display.
  */
 void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
                    int rssi, uint32_t batVoltage) {
+  DisplayList &gfx = renderTarget();
+  const layout_widget_t &bar = LAYOUT[LAYOUT_STATUS_BAR];
+  // items are right aligned to pos, from right to left
+  const int bottom = layoutBottom(bar.box);
+  const int baseline = bottom - 3;
   String dataStr;
   uint16_t dataColor = GxEPD_BLACK;
-  display.setFont(&FONT_6pt8b);
-  int pos = DISP_WIDTH - 2;
+  setLayoutFont(bar);
+  int pos = layoutRight(bar.box) - 2;
   const int sp = 2;
 
 #if BATTERY_MONITORING
@@ -665,9 +1150,9 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
 #if STATUS_BAR_EXTRAS_BAT_VOLTAGE
   dataStr += " (" + String(std::round(batVoltage / 10.f) / 100.f, 2) + "v)";
 #endif
-  drawString(pos, DISP_HEIGHT - 1 - 2, dataStr, RIGHT, dataColor);
+  drawString(pos, baseline, dataStr, bar.align, dataColor);
   pos -= getStringWidth(dataStr) + 25;
-  display.drawInvertedBitmap(pos, DISP_HEIGHT - 1 - 17,
+  gfx.drawInvertedBitmap(pos, bottom - 18,
                              getBatBitmap24(batPercent), 24, 24, dataColor);
   pos -= sp + 9;
 #endif
@@ -680,26 +1165,43 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
     dataStr += " (" + String(rssi) + "dBm)";
   }
 #endif
-  drawString(pos, DISP_HEIGHT - 1 - 2, dataStr, RIGHT, dataColor);
+  drawString(pos, baseline, dataStr, bar.align, dataColor);
+#if SKIP_UNCHANGED_IGNORE_WIFI_SIGNAL
+  markStatusVolatile(pos - getStringWidth(dataStr) - 19, pos);
+#endif
   pos -= getStringWidth(dataStr) + 19;
-  display.drawInvertedBitmap(pos, DISP_HEIGHT - 1 - 13, getWiFiBitmap16(rssi),
+  gfx.drawInvertedBitmap(pos, bottom - 14, getWiFiBitmap16(rssi),
                              16, 16, dataColor);
   pos -= sp + 8;
 
   // last refresh
+  dataStr = refreshTimeStr;
   dataColor = GxEPD_BLACK;
-  drawString(pos, DISP_HEIGHT - 1 - 2, refreshTimeStr, RIGHT, dataColor);
-  pos -= getStringWidth(refreshTimeStr) + 25;
-  display.drawInvertedBitmap(pos, DISP_HEIGHT - 1 - 21, wi_refresh_32x32, 32,
+#if STATUS_BAR_EXTRAS_REFRESH
+  // how the previous refresh was done, this one is still to come
+  if (lastRefreshMode != REFRESH_NONE) {
+    const char *mode = lastRefreshMode == REFRESH_PARTIAL ? TXT_REFRESH_PARTIAL
+                       : lastRefreshMode == REFRESH_FAST  ? TXT_REFRESH_FAST
+                                                          : TXT_REFRESH_FULL;
+    dataStr += " (" + String(mode) + " "
+               + String(lastRefreshMillis / 1000.f, 1) + "s)";
+  }
+#endif
+  drawString(pos, baseline, dataStr, bar.align, dataColor);
+#if SKIP_UNCHANGED_IGNORE_REFRESH_TIME
+  markStatusVolatile(pos - getStringWidth(dataStr) - 25, pos);
+#endif
+  pos -= getStringWidth(dataStr) + 25;
+  gfx.drawInvertedBitmap(pos, bottom - 22, wi_refresh_32x32, 32,
                              32, dataColor);
   pos -= sp;
 
   // status
   dataColor = ACCENT_COLOR;
   if (!statusStr.isEmpty()) {
-    drawString(pos, DISP_HEIGHT - 1 - 2, statusStr, RIGHT, dataColor);
+    drawString(pos, baseline, statusStr, bar.align, dataColor);
     pos -= getStringWidth(statusStr) + 24;
-    display.drawInvertedBitmap(pos, DISP_HEIGHT - 1 - 18, error_icon_24x24, 24,
+    gfx.drawInvertedBitmap(pos, bottom - 19, error_icon_24x24, 24,
                                24, dataColor);
   }
 
@@ -714,18 +1216,19 @@ void drawStatusBar(const String &statusStr, const String &refreshTimeStr,
  */
 void drawError(const uint8_t *bitmap_196x196, const String &errMsgLn1,
                const String &errMsgLn2) {
-  display.setFont(&FONT_26pt8b);
+  DisplayList &gfx = renderTarget();
+  const layout_widget_t &message = LAYOUT[LAYOUT_ERROR_MESSAGE];
+  const dl_rect_t &icon = LAYOUT[LAYOUT_ERROR_ICON].box;
+  const int x = layoutCenterX(message.box);
+  const int y = message.box.y + 42; // baseline of the first line
+  setLayoutFont(message);
   if (!errMsgLn2.isEmpty()) {
-    drawString(DISP_WIDTH / 2, DISP_HEIGHT / 2 + 196 / 2 + 21, errMsgLn1,
-               CENTER);
-    drawString(DISP_WIDTH / 2, DISP_HEIGHT / 2 + 196 / 2 + 21 + 55, errMsgLn2,
-               CENTER);
+    drawString(x, y, errMsgLn1, message.align);
+    drawString(x, y + 55, errMsgLn2, message.align);
   } else {
-    drawMultiLnString(DISP_WIDTH / 2, DISP_HEIGHT / 2 + 196 / 2 + 21, errMsgLn1,
-                      CENTER, DISP_WIDTH - 200, 2, 55);
+    drawMultiLnString(x, y, errMsgLn1, message.align, message.box.w, 2, 55);
   }
-  display.drawInvertedBitmap(DISP_WIDTH / 2 - 196 / 2,
-                             DISP_HEIGHT / 2 - 196 / 2 - 21, bitmap_196x196,
-                             196, 196, ACCENT_COLOR);
+  gfx.drawInvertedBitmap(icon.x, icon.y, bitmap_196x196, 196, 196,
+                             ACCENT_COLOR);
   return;
 } // end drawError
@@ -0,0 +1,178 @@
+/* Text metrics for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include <Arduino.h>
+
+#include "text_metrics.h"
+
+/* Returns the bounds of a single line of text printed with font at text size
+ * 1, the same as Adafruit_GFX::getTextBounds() at cursor (0, 0) gives. Only
+ * the glyph table is read, each glyph's box and advance, once per character.
+ */
+text_bounds_t measureText(const GFXfont *font, const char *text) {
+  uint8_t first = pgm_read_byte(&font->first);
+  uint8_t last = pgm_read_byte(&font->last);
+  int16_t x = 0;
+  int16_t minx = INT16_MAX, miny = INT16_MAX, maxx = -1, maxy = -1;
+  for (const uint8_t *c = reinterpret_cast<const uint8_t *>(text); *c; ++c) {
+    if (*c < first || *c > last) {
+      continue; // includes '\r', which is skipped as well
+    }
+    const GFXglyph *glyph = &font->glyph[*c - first];
+    int16_t x1 = x + static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+    int16_t y1 = static_cast<int8_t>(pgm_read_byte(&glyph->yOffset));
+    minx = std::min(minx, x1);
+    miny = std::min(miny, y1);
+    maxx = std::max<int16_t>(maxx, x1 + pgm_read_byte(&glyph->width) - 1);
+    maxy = std::max<int16_t>(maxy, y1 + pgm_read_byte(&glyph->height) - 1);
+    x += pgm_read_byte(&glyph->xAdvance);
+  }
+
+  text_bounds_t b = {0, 0, 0, 0};
+  if (maxx >= minx) {
+    b.x = minx;
+    b.w = maxx - minx + 1;
+  }
+  if (maxy >= miny) {
+    b.y = miny;
+    b.h = maxy - miny + 1;
+  }
+  return b;
+} // end measureText
+
+/* Horizontal extent of glyphs added one at a time, accumulated the way
+ * Adafruit_GFX::getTextBounds() does.
+ */
+typedef struct text_run {
+  int16_t x;
+  int16_t minx;
+  int16_t maxx;
+} text_run_t;
+
+static const text_run_t emptyRun = {0, INT16_MAX, -1};
+
+static void addGlyph(text_run_t &run, const GFXfont *font, uint8_t c) {
+  if (c < pgm_read_byte(&font->first) || c > pgm_read_byte(&font->last)) {
+    return;
+  }
+  const GFXglyph *glyph = &font->glyph[c - pgm_read_byte(&font->first)];
+  int16_t x1 = run.x + static_cast<int8_t>(pgm_read_byte(&glyph->xOffset));
+  run.minx = std::min(run.minx, x1);
+  run.maxx = std::max<int16_t>(run.maxx, x1 + pgm_read_byte(&glyph->width) - 1);
+  run.x += pgm_read_byte(&glyph->xAdvance);
+  return;
+} // end addGlyph
+
+static uint16_t runWidth(const text_run_t &run) {
+  return run.maxx >= run.minx ? run.maxx - run.minx + 1 : 0;
+} // end runWidth
+
+/* Returns the width of run followed by tail, which was measured on its own.
+ */
+static uint16_t runWidth(const text_run_t &run, const text_run_t &tail) {
+  return runWidth({0, std::min<int16_t>(run.minx, run.x + tail.minx),
+                   std::max<int16_t>(run.maxx, run.x + tail.maxx)});
+} // end runWidth
+
+/* Breaks the longest line off the start of text that is at most maxWidth
+ * wide. Lines break after a dash or before a space, which is dropped. The
+ * last line only breaks at spaces, and gets an ellipsis when the text does
+ * not fit; its width includes the ellipsis then. A word wider than maxWidth
+ * is not broken, it overflows.
+ *
+ * The text is read once, from the start until the line is full, and each
+ * character's advance is added to the width so far. Widths only grow as the
+ * line does, so the last break that fits is the one to take.
+ */
+text_line_t breakLine(const GFXfont *font, const char *text,
+                      uint16_t maxWidth, bool last) {
+  text_run_t ellipsis = emptyRun;
+  for (const char *c = "..."; *c; ++c) {
+    addGlyph(ellipsis, font, *c);
+  }
+
+  text_run_t run = emptyRun;
+  text_line_t fit = {0, 0, false, 0};
+  text_line_t first = fit;
+  bool haveFit = false;
+  bool haveFirst = false;
+  // a line of text[0, len), with the next one starting at next
+  auto candidate = [&](uint16_t len, uint16_t next) {
+    uint16_t w = last ? runWidth(run, ellipsis) : runWidth(run);
+    if (!haveFirst) {
+      first = {len, runWidth(run), false, next};
+      haveFirst = true;
+    }
+    if (w <= maxWidth) {
+      fit = {len, w, last, next};
+      haveFit = true;
+    }
+  };
+
+  uint16_t i = 0;
+  bool overflow = false;
+  for (; text[i] && !(overflow && haveFirst); ++i) {
+    uint8_t c = text[i];
+    if (c == ' ') {
+      candidate(i, i + 1);
+    }
+    addGlyph(run, font, c);
+    if (c == '-' && !last) {
+      candidate(i + 1, i + 1);
+    }
+    overflow = overflow || runWidth(run) > maxWidth;
+  }
+  if (!overflow) {
+    return {i, runWidth(run), false, i}; // the rest fits
+  }
+  if (haveFit) {
+    return fit;
+  }
+  if (haveFirst) {
+    return first;
+  }
+  return {i, runWidth(run), false, i};
+} // end breakLine
+
+TextCache::TextCache() : _entries(), _tick(0) {}
+
+/* Returns measureText(font, text), from the cache if it was measured
+ * recently. The least recently used entry makes room for a new string.
+ */
+text_bounds_t TextCache::measure(const GFXfont *font, const char *text) {
+  size_t len = strlen(text);
+  if (len >= TEXT_CACHE_LEN) {
+    return measureText(font, text);
+  }
+  entry_t *lru = &_entries[0];
+  for (entry_t &e : _entries) {
+    if (e.font == font && memcmp(e.text, text, len + 1) == 0) {
+      e.lastUse = ++_tick;
+      return e.bounds;
+    }
+    if (e.lastUse < lru->lastUse) {
+      lru = &e;
+    }
+  }
+  lru->font = font;
+  lru->lastUse = ++_tick;
+  lru->bounds = measureText(font, text);
+  memcpy(lru->text, text, len + 1);
+  return lru->bounds;
+} // end measure
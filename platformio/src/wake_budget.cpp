@@ -0,0 +1,161 @@
+/* Wake budget for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#include "config.h"
+#include "power_utils.h"
+#include "wake_budget.h"
+
+// Typical current drawn by the whole board in each phase (mA), used to estimate
+// the charge spent by a wake. Light sleep during waits is not accounted for, so
+// the estimate errs on the high side.
+static const float PHASE_CURRENT_MA[PHASE_COUNT] = {
+    40.0f,  // Boot
+    110.0f, // Network, radio on
+    50.0f,  // Parse, 240MHz
+    20.0f,  // Sensor
+    50.0f,  // Render, 240MHz
+    25.0f,  // Display, panel charge pump running
+};
+
+// phase that first ran out of budget this wake, PHASE_COUNT if none
+static wake_phase_t overrunPhase = PHASE_COUNT;
+static bool diagnosticsSaved = false;
+
+/* Returns the estimated charge used so far this wake (mAs).
+ */
+float budgetChargeUsed() {
+  float mAs = 0;
+  for (int p = 0; p < PHASE_COUNT; ++p) {
+    wake_phase_t wp = static_cast<wake_phase_t>(p);
+    mAs += PHASE_CURRENT_MA[p] * (getPhaseMicros(wp) / 1000000.0f);
+  }
+  return mAs;
+} // end budgetChargeUsed
+
+/* Returns the time left in the wake budget (ms). This is the lesser of the
+ * time budget and how long the remaining charge budget lasts at the current
+ * phase's current draw.
+ */
+uint32_t budgetRemainingMs() {
+  uint32_t elapsed = millis();
+  if (elapsed >= WAKE_TIME_BUDGET) {
+    return 0;
+  }
+  uint32_t timeLeft = WAKE_TIME_BUDGET - elapsed;
+
+  float chargeLeft = WAKE_CHARGE_BUDGET - budgetChargeUsed();
+  if (chargeLeft <= 0) {
+    return 0;
+  }
+  float chargeMs = chargeLeft / PHASE_CURRENT_MA[currentPhase()] * 1000.0f;
+  return chargeMs < timeLeft ? static_cast<uint32_t>(chargeMs) : timeLeft;
+} // end budgetRemainingMs
+
+/* Returns timeoutMs, shortened if necessary so that waiting for it does not
+ * exceed the wake budget.
+ */
+uint32_t budgetClampTimeout(uint32_t timeoutMs) {
+  uint32_t remaining = budgetRemainingMs();
+  return timeoutMs < remaining ? timeoutMs : remaining;
+} // end budgetClampTimeout
+
+/* Returns true if at least ms of the wake budget remain. Otherwise the current
+ * phase is recorded as having overrun the budget and false is returned.
+ */
+bool budgetAllows(uint32_t ms) {
+  if (budgetRemainingMs() >= ms) {
+    return true;
+  }
+  if (overrunPhase == PHASE_COUNT) {
+    overrunPhase = currentPhase();
+    Serial.printf("Wake budget exhausted in phase %s\n",
+                  getPhaseName(overrunPhase));
+  }
+  return false;
+} // end budgetAllows
+
+/* Returns true if some phase has run out of budget this wake. Work that is
+ * not essential, like retries or an error screen, should then be skipped.
+ */
+bool budgetExhausted() {
+  return overrunPhase != PHASE_COUNT;
+} // end budgetExhausted
+
+/* If the budget was overrun this wake, counts it against the overrunning phase
+ * in non-volatile storage. Nothing is written otherwise, to spare the flash.
+ * Only the first call per wake has any effect.
+ */
+void budgetSaveDiagnostics() {
+  if (diagnosticsSaved || overrunPhase == PHASE_COUNT) {
+    return;
+  }
+  diagnosticsSaved = true;
+
+  Preferences prefs;
+  prefs.begin(NVS_NAMESPACE, false);
+  uint16_t counts[PHASE_COUNT] = {};
+  if (prefs.isKey("ovrCounts")) {
+    prefs.getBytes("ovrCounts", counts, sizeof(counts));
+  }
+  if (counts[overrunPhase] < UINT16_MAX) {
+    ++counts[overrunPhase];
+  }
+  prefs.putBytes("ovrCounts", counts, sizeof(counts));
+  prefs.putUChar("ovrLast", static_cast<uint8_t>(overrunPhase));
+  prefs.end();
+  return;
+} // end budgetSaveDiagnostics
+
+/* Prints the budget overruns recorded in non-volatile storage.
+ */
+void budgetPrintDiagnostics() {
+  Preferences prefs;
+  prefs.begin(NVS_NAMESPACE, true);
+  uint16_t counts[PHASE_COUNT] = {};
+  if (prefs.isKey("ovrCounts")) {
+    prefs.getBytes("ovrCounts", counts, sizeof(counts));
+  }
+  uint8_t last = prefs.getUChar("ovrLast", PHASE_COUNT);
+  prefs.end();
+
+  Serial.print("[debug] Budget overruns   :");
+  for (int p = 0; p < PHASE_COUNT; ++p) {
+    if (counts[p] > 0) {
+      Serial.printf(" %s=%u", getPhaseName(static_cast<wake_phase_t>(p)),
+                    counts[p]);
+    }
+  }
+  if (last < PHASE_COUNT) {
+    Serial.printf(" (last: %s)",
+                  getPhaseName(static_cast<wake_phase_t>(last)));
+  }
+  Serial.println();
+  return;
+} // end budgetPrintDiagnostics
+
+/* Prints the estimated charge used this wake against the budget.
+ */
+void budgetPrintStats() {
+  Serial.printf("%-15s %6.0fmAs of %lumAs%s\n", "Charge (est.)",
+                budgetChargeUsed(),
+                static_cast<unsigned long>(WAKE_CHARGE_BUDGET),
+                budgetExhausted() ? ", budget exhausted" : "");
+  return;
+} // end budgetPrintStats
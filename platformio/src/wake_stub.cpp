@@ -0,0 +1,137 @@
+/* Deep-sleep wake stub for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+
+#include "wake_stub.h"
+
+#ifdef ESP_PLATFORM
+#include <rom/rtc.h>
+#include <soc/rtc.h>
+#include <soc/rtc_cntl_reg.h>
+#include <soc/uart_reg.h>
+
+// The schedule table lives in RTC slow memory so that it survives deep sleep
+// and can be read by the stub before the bootloader has even run. Each entry
+// is the number of RTC slow clock ticks the stub should sleep for when it
+// absorbs a wake. Ticks are computed by the application because the stub
+// cannot safely call anything outside of ROM and RTC memory.
+static RTC_DATA_ATTR uint64_t wakeSchedule[WAKE_STUB_MAX_SLOTS];
+static RTC_DATA_ATTR uint32_t wakeScheduleLen;
+static RTC_DATA_ATTR uint32_t wakeScheduleNext;
+static RTC_DATA_ATTR uint32_t wakesSkipped;
+
+/* Runs from RTC fast memory immediately after every deep sleep wake, before
+ * the ROM loads the bootloader. If the schedule table says this wake is not
+ * needed by the application, re-arm the RTC timer and go straight back to
+ * sleep. Otherwise return and let the normal boot continue.
+ *
+ * Only ROM functions, RTC_IRAM_ATTR functions and RTC_DATA_ATTR variables may
+ * be used in here.
+ */
+void RTC_IRAM_ATTR esp_wake_deep_sleep(void) {
+  esp_default_wake_deep_sleep();
+
+  // only timer wakes are scheduled, anything else always boots
+  uint32_t cause = REG_GET_FIELD(RTC_CNTL_WAKEUP_STATE_REG,
+                                 RTC_CNTL_WAKEUP_CAUSE);
+  if (!(cause & RTC_TIMER_TRIG_EN) || wakeScheduleNext >= wakeScheduleLen) {
+    return;
+  }
+
+  uint64_t ticks = wakeSchedule[wakeScheduleNext];
+  ++wakeScheduleNext;
+  ++wakesSkipped;
+
+  // latch the current RTC time and arm the timer relative to it
+  SET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_UPDATE);
+  while (GET_PERI_REG_MASK(RTC_CNTL_TIME_UPDATE_REG, RTC_CNTL_TIME_VALID) == 0)
+  {
+    ets_delay_us(1);
+  }
+  SET_PERI_REG_MASK(RTC_CNTL_INT_CLR_REG, RTC_CNTL_TIME_VALID_INT_CLR);
+  uint64_t now = READ_PERI_REG(RTC_CNTL_TIME0_REG);
+  now |= static_cast<uint64_t>(READ_PERI_REG(RTC_CNTL_TIME1_REG)) << 32;
+  uint64_t target = now + ticks;
+  WRITE_PERI_REG(RTC_CNTL_SLP_TIMER0_REG, target & UINT32_MAX);
+  WRITE_PERI_REG(RTC_CNTL_SLP_TIMER1_REG, target >> 32);
+
+  // wait for the ROM bootloader messages to leave the UART
+  while (REG_GET_FIELD(UART_STATUS_REG(0), UART_ST_UTX_OUT)) {
+  }
+
+  REG_WRITE(RTC_ENTRY_ADDR_REG, reinterpret_cast<uint32_t>(&esp_wake_deep_sleep));
+  CLEAR_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_SLEEP_EN);
+  SET_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_SLEEP_EN);
+  while (true) {
+  }
+} // end esp_wake_deep_sleep
+
+/* Empties the schedule table. The next timer wake will boot the application.
+ */
+void wakeStubClear() {
+  wakeScheduleLen = 0;
+  wakeScheduleNext = 0;
+  return;
+} // end wakeStubClear
+
+/* Appends a wake to the schedule table that the stub should absorb without
+ * booting, after which it sleeps for sleepSeconds. Slots are consumed in
+ * order, starting with the wake that ends the sleep about to begin.
+ *
+ * Returns false if the table is full.
+ */
+bool wakeStubAddSkip(uint64_t sleepSeconds) {
+  if (wakeScheduleLen >= WAKE_STUB_MAX_SLOTS) {
+    return false;
+  }
+  // RTC_SLOW_CLK_CAL_REG holds the calibrated slow clock period as a Q13.19
+  // fixed point number of microseconds, the same value esp_sleep uses.
+  uint32_t period = REG_READ(RTC_SLOW_CLK_CAL_REG);
+  if (period == 0) {
+    return false;
+  }
+  wakeSchedule[wakeScheduleLen] =
+      rtc_time_us_to_slowclk(sleepSeconds * 1000000ULL, period);
+  ++wakeScheduleLen;
+  return true;
+} // end wakeStubAddSkip
+
+/* Returns the number of wakes currently scheduled to be absorbed by the stub.
+ */
+uint32_t wakeStubSlots() {
+  return wakeScheduleLen - wakeScheduleNext;
+} // end wakeStubSlots
+
+/* Returns the number of wakes absorbed by the stub since power-on.
+ */
+uint32_t wakeStubSkippedWakes() {
+  return wakesSkipped;
+} // end wakeStubSkippedWakes
+
+#else
+// Host builds have no RTC memory or wake stub. Every wake boots the
+// application, so nothing can be scheduled.
+
+void wakeStubClear() {}
+bool wakeStubAddSkip(uint64_t sleepSeconds) { return false; }
+uint32_t wakeStubSlots() { return 0; }
+uint32_t wakeStubSkippedWakes() { return 0; }
+
+#endif
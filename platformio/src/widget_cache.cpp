@@ -0,0 +1,159 @@
+/* Widget render cache for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "widget_cache.h"
+#include "frame_diff.h"
+#include <esp_attr.h>
+
+// A widget in a frame: the hash of its inputs, the box its pixels are in, a
+// value it needs when it is copied and the calls it was drawn with.
+typedef struct widget_cache_entry
+{
+  bool valid;
+  uint32_t hash;
+  dl_rect_t box;
+  int16_t value;
+  uint16_t first;
+  uint16_t last;
+} widget_cache_entry_t;
+
+// The widgets in the frame on the panel, kept across deep sleep along with the
+// lookups and hits since the last reset. Their pixels are read from the stored
+// frame, see frameReadPrevious().
+static RTC_DATA_ATTR widget_cache_entry_t cached[WIDGET_CACHE_SLOTS];
+static RTC_DATA_ATTR uint32_t lookups[WIDGET_CACHE_SLOTS];
+static RTC_DATA_ATTR uint32_t hits[WIDGET_CACHE_SLOTS];
+
+// the widgets in the frame being drawn, and the pixels of those copied from the
+// stored frame, which the frame's display list points to
+static widget_cache_entry_t next[WIDGET_CACHE_SLOTS];
+static std::vector<uint8_t> tiles[WIDGET_CACHE_SLOTS];
+
+static const char *const slotNames[WIDGET_CACHE_SLOTS] = {
+    "location",   "indoor temp", "indoor humidity", "forecast 1",
+    "forecast 2", "forecast 3",  "forecast 4",      "forecast 5"};
+
+/* Starts a new frame, with no widgets in it yet.
+ */
+void widgetCacheBegin() {
+  for (uint8_t i = 0; i < WIDGET_CACHE_SLOTS; ++i) {
+    next[i].valid = false;
+    std::vector<uint8_t>().swap(tiles[i]);
+  }
+  return;
+} // end widgetCacheBegin
+
+/* Draws a widget whose inputs hash to hash by copying its pixels from the
+ * stored frame, if it was drawn there from the same inputs. value is set to
+ * the value it was added with. Returns false, and draws nothing, if it has to
+ * be drawn again, see widgetCacheAdd().
+ */
+bool widgetCacheDraw(DisplayList &gfx, widget_cache_slot_t slot, uint32_t hash,
+                     int16_t &value) {
+  ++lookups[slot];
+  const widget_cache_entry_t &entry = cached[slot];
+  if (!entry.valid || entry.hash != hash) {
+    return false;
+  }
+  // the stored frame is read a byte at a time
+  const dl_rect_t &box = entry.box;
+  int16_t x0 = box.x & ~7;
+  int16_t x1 = (box.x + box.w + 7) & ~7;
+  size_t rowBytes = (x1 - x0) / 8;
+  std::vector<uint8_t> &tile = tiles[slot];
+  tile.resize(rowBytes * box.h);
+  if (!frameReadPrevious({x0, box.y, static_cast<int16_t>(x1 - x0), box.h},
+                         tile.data())) {
+    return false;
+  }
+  // leave out what the rounding took from the neighbours (1 = white)
+  uint8_t left = 0xFF00 >> (box.x - x0);
+  uint8_t right = 0xFF >> (8 - (x1 - box.x - box.w));
+  for (int16_t y = 0; y < box.h; ++y) {
+    uint8_t *row = tile.data() + y * rowBytes;
+    row[0] |= left;
+    row[rowBytes - 1] |= right;
+  }
+  size_t first = gfx.size();
+  gfx.drawInvertedBitmap(x0, box.y, tile.data(), x1 - x0, box.h, GxEPD_BLACK);
+  ++hits[slot];
+  value = entry.value;
+  next[slot] = entry;
+  next[slot].first = first;
+  next[slot].last = gfx.size();
+  return true;
+} // end widgetCacheDraw
+
+/* Records that a widget was drawn from inputs that hash to hash, with the
+ * calls from first to the last one recorded. value is handed back when it is
+ * copied, e.g. for what was measured while drawing it.
+ */
+void widgetCacheAdd(const DisplayList &gfx, widget_cache_slot_t slot,
+                    uint32_t hash, size_t first, int16_t value) {
+  const dl_rect_t panel = {0, 0, gfx.width(), gfx.height()};
+  dl_rect_t box = gfx.inkBounds(first, gfx.size(), panel);
+  next[slot] = {box.w > 0, hash, box, value, static_cast<uint16_t>(first),
+                static_cast<uint16_t>(gfx.size())};
+  return;
+} // end widgetCacheAdd
+
+/* Returns true if nothing but the widget's own calls and the first background
+ * calls, which draw the same pixels into every frame, draws into its box, so
+ * that the stored frame has just its pixels there, and no volatile region,
+ * which is updated on its own, covers it.
+ */
+static bool ownsBox(const DisplayList &list, size_t background,
+                    const widget_cache_entry_t &e) {
+  if (list.inkBounds(background, e.first, e.box).w > 0
+      || list.inkBounds(e.last, list.size(), e.box).w > 0) {
+    return false;
+  }
+  for (const dl_rect_t &r : list.volatileRects()) {
+    if (r.x < e.box.x + e.box.w && e.box.x < r.x + r.w
+        && r.y < e.box.y + e.box.h && e.box.y < r.y + r.h) {
+      return false;
+    }
+  }
+  return true;
+} // end ownsBox
+
+/* Called once a frame has been stored, see frameSave(), with the display list
+ * it was drawn from or nullptr if it was not this frame, and the number of
+ * background calls it starts with. Its widgets can then be copied from it.
+ */
+void widgetCacheSave(const DisplayList *list, size_t background) {
+  for (uint8_t i = 0; i < WIDGET_CACHE_SLOTS; ++i) {
+    cached[i] = next[i];
+    cached[i].valid =
+        list != nullptr && next[i].valid && ownsBox(*list, background, next[i]);
+  }
+  return;
+} // end widgetCacheSave
+
+/* Prints how often each widget was copied rather than drawn since the last
+ * reset.
+ */
+void widgetCacheReport() {
+  for (uint8_t i = 0; i < WIDGET_CACHE_SLOTS; ++i) {
+    Serial.printf("Widget cache %-15s %u/%u hits\n", slotNames[i],
+                  static_cast<unsigned>(hits[i]),
+                  static_cast<unsigned>(lookups[i]));
+  }
+  return;
+} // end widgetCacheReport
@@ -0,0 +1,381 @@
+/* Batch renderer for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <dirent.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+
+#include "api_response.h"
+#include "config.h"
+#include "display_utils.h"
+#include "renderer.h"
+
+/* Renders every Bright Sky response (*.json) in a directory on the host, on
+ * all cores, and writes each frame and a CSV of the time spent parsing and
+ * drawing each widget. Useful for finding layout overflow and slow paths over
+ * a large set of recorded or generated forecasts.
+ *
+ * Each worker thread records into its own display list (see setRenderTarget)
+ * and replays it into its own frame buffer.
+ * Units, fonts and locales are selected at compile time, so each combination
+ * is a separate build, as with tools/render_check.sh.
+ */
+
+typedef enum widget
+{
+  WIDGET_CURRENT,
+  WIDGET_OUTLOOK,
+  WIDGET_FORECAST,
+  WIDGET_LOCATION,
+  WIDGET_STATUS,
+  WIDGET_FRAME, // rasterizing the recorded frame into the frame buffer
+  WIDGET_COUNT
+} widget_t;
+
+static const char *WIDGET_NAMES[WIDGET_COUNT] = {
+    "drawCurrentConditions", "drawOutlookGraph", "drawForecast",
+    "drawLocationDate", "drawStatusBar", "drawFrame"};
+
+typedef struct options {
+  std::string in;
+  std::string out = "batch_out";
+  std::string now; // local time, YYYY-MM-DD HH:MM, empty for per file
+  unsigned threads = 0;
+  bool images = true;
+  bool verbose = false;
+} options_t;
+
+typedef struct job {
+  std::string name; // file name without .json
+  unsigned thread = 0;
+  std::string error;
+  uint64_t parseMicros = 0;
+  uint64_t widgetMicros[WIDGET_COUNT] = {};
+  uint64_t totalMicros = 0;
+} job_t;
+
+/* Job indices of one worker. The owner takes jobs from the back, idle workers
+ * steal from the front, so they rarely contend for the same end.
+ */
+class WorkQueue {
+public:
+  void push(size_t job) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _jobs.push_back(job);
+  }
+  bool pop(size_t &job) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_jobs.empty()) {
+      return false;
+    }
+    job = _jobs.back();
+    _jobs.pop_back();
+    return true;
+  }
+  bool steal(size_t &job) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_jobs.empty()) {
+      return false;
+    }
+    job = _jobs.front();
+    _jobs.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex _mutex;
+  std::deque<size_t> _jobs;
+};
+
+static bool readFile(const std::string &path, std::string &data) {
+  FILE *f = fopen(path.c_str(), "rb");
+  if (f == nullptr) {
+    return false;
+  }
+  char buf[16384];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    data.append(buf, n);
+  }
+  bool ok = !ferror(f);
+  fclose(f);
+  return ok;
+} // end readFile
+
+/* Parses a local time (YYYY-MM-DD HH:MM, or the start of an ISO 8601
+ * timestamp) into timeInfo. Returns false if it is not a valid time.
+ */
+static bool parseLocalTime(const char *str, tm &timeInfo) {
+  timeInfo = {};
+  const char *end = strptime(str, "%Y-%m-%d %H:%M", &timeInfo);
+  if (end == nullptr) {
+    end = strptime(str, "%Y-%m-%dT%H:%M", &timeInfo);
+  }
+  if (end == nullptr) {
+    return false;
+  }
+  timeInfo.tm_isdst = -1;
+  return mktime(&timeInfo) != -1;
+} // end parseLocalTime
+
+/* Finds the first timestamp in a response, which is used as the time of the
+ * refresh unless --now is given.
+ */
+static bool firstTimestamp(const std::string &json, tm &timeInfo) {
+  size_t pos = json.find("\"timestamp\"");
+  if (pos != std::string::npos) {
+    pos = json.find(':', pos);
+  }
+  if (pos != std::string::npos) {
+    pos = json.find('"', pos);
+  }
+  if (pos == std::string::npos) {
+    return false;
+  }
+  return parseLocalTime(json.c_str() + pos + 1, timeInfo);
+} // end firstTimestamp
+
+/* Parses and draws one response into the calling thread's frame buffer.
+ */
+static void renderJob(const options_t &opt, display_t &fb, job_t &job) {
+  uint64_t start = micros();
+  std::string json;
+  if (!readFile(opt.in + "/" + job.name + ".json", json)) {
+    job.error = "could not read file";
+    return;
+  }
+  tm now;
+  if (opt.now.empty() ? !firstTimestamp(json, now)
+                      : !parseLocalTime(opt.now.c_str(), now)) {
+    job.error = "no valid time";
+    return;
+  }
+
+  std::unique_ptr<dwd_resp_onecall_t> r(new dwd_resp_onecall_t());
+  WiFiClient client;
+  client.setReceived(json);
+  uint64_t t0 = micros();
+  DeserializationError err = deserializeOneCall(client, *r, now);
+  job.parseMicros = micros() - t0;
+  if (err) {
+    job.error = std::string("response not parsed: ") + err.c_str();
+    return;
+  }
+
+  String refreshTimeStr;
+  getRefreshTimeStr(refreshTimeStr, true, &now);
+  String dateStr;
+  getDateStr(dateStr, &now);
+
+  beginFrame();
+  drawBackground();
+  uint64_t t[WIDGET_COUNT + 1];
+  t[0] = micros();
+  drawCurrentConditions(r->current, r->days[0], 21.5f, 45.f);
+  t[1] = micros();
+  drawOutlookGraph(r->hours, r->days, now);
+  t[2] = micros();
+  drawForecast(r->days, now);
+  t[3] = micros();
+  drawLocationDate(CITY_STRING, dateStr);
+  t[4] = micros();
+  drawStatusBar("", refreshTimeStr, -60, 4000);
+  t[5] = micros();
+  drawFrame(fb);
+  t[6] = micros();
+  for (int w = 0; w < WIDGET_COUNT; ++w) {
+    job.widgetMicros[w] += t[w + 1] - t[w];
+  }
+
+  if (opt.images) {
+    std::string frame = opt.out + "/" + job.name;
+    if (!fb.epd2.savePanel(frame.c_str())) {
+      job.error = "could not write " + frame + ".png";
+    }
+  }
+  job.totalMicros = micros() - start;
+  return;
+} // end renderJob
+
+/* Runs jobs from the worker's own queue, then steals from the others until
+ * every queue is empty. No jobs are added once the workers have started, so
+ * an empty sweep over all queues means the batch is done.
+ */
+static void worker(const options_t &opt, unsigned id,
+                   std::vector<WorkQueue> &queues, std::vector<job_t> &jobs) {
+  // these are large, they do not belong on a thread's stack
+  std::unique_ptr<DisplayList> list(new DisplayList(DISP_WIDTH, DISP_HEIGHT));
+  std::unique_ptr<display_t> fb(
+      new display_t(GxEPD2_750_T7_Fast(-1, -1, -1, -1)));
+  setRenderTarget(list.get());
+
+  size_t n = queues.size();
+  while (true) {
+    size_t j;
+    bool found = queues[id].pop(j);
+    for (size_t i = 1; !found && i < n; ++i) {
+      found = queues[(id + i) % n].steal(j);
+    }
+    if (!found) {
+      break;
+    }
+    jobs[j].thread = id;
+    renderJob(opt, *fb, jobs[j]);
+  }
+  setRenderTarget(nullptr);
+  return;
+} // end worker
+
+static bool writeCsv(const std::string &path, const std::vector<job_t> &jobs) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "file,thread,parse_us");
+  for (const char *name : WIDGET_NAMES) {
+    fprintf(f, ",%s_us", name);
+  }
+  fprintf(f, ",total_us,error\n");
+  for (const job_t &job : jobs) {
+    fprintf(f, "%s,%u,%llu", job.name.c_str(), job.thread,
+            static_cast<unsigned long long>(job.parseMicros));
+    for (uint64_t us : job.widgetMicros) {
+      fprintf(f, ",%llu", static_cast<unsigned long long>(us));
+    }
+    fprintf(f, ",%llu,%s\n", static_cast<unsigned long long>(job.totalMicros),
+            job.error.c_str());
+  }
+  return fclose(f) == 0;
+} // end writeCsv
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [--out DIR] [--threads N] [--now \"YYYY-MM-DD HH:MM\"]\n"
+          "          [--no-images] [--verbose] INPUT_DIR\n",
+          prog);
+  return;
+} // end usage
+
+static bool parseArgs(int argc, char **argv, options_t &opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--out" && hasValue) {
+      opt.out = argv[++i];
+    } else if (a == "--threads" && hasValue) {
+      opt.threads = std::max(1, atoi(argv[++i]));
+    } else if (a == "--now" && hasValue) {
+      opt.now = argv[++i];
+    } else if (a == "--no-images") {
+      opt.images = false;
+    } else if (a == "--verbose") {
+      opt.verbose = true;
+    } else if (opt.in.empty() && a[0] != '-') {
+      opt.in = a;
+    } else {
+      return false;
+    }
+  }
+  return !opt.in.empty();
+} // end parseArgs
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage(argv[0]);
+    return 2;
+  }
+  if (opt.threads == 0) {
+    opt.threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  std::vector<job_t> jobs;
+  DIR *dir = opendir(opt.in.c_str());
+  if (dir == nullptr) {
+    fprintf(stderr, "could not open %s\n", opt.in.c_str());
+    return 2;
+  }
+  while (dirent *e = readdir(dir)) {
+    std::string name = e->d_name;
+    if (name.size() > 5 && name.compare(name.size() - 5, 5, ".json") == 0) {
+      jobs.emplace_back();
+      jobs.back().name = name.substr(0, name.size() - 5);
+    }
+  }
+  closedir(dir);
+  std::sort(jobs.begin(), jobs.end(), [](const job_t &a, const job_t &b) {
+    return a.name < b.name;
+  });
+  if (jobs.empty()) {
+    fprintf(stderr, "no .json files in %s\n", opt.in.c_str());
+    return 2;
+  }
+  mkdir(opt.out.c_str(), 0755);
+
+  setenv("TZ", TIMEZONE, 1);
+  tzset();
+  // the renderer logs to Serial, which would interleave between threads
+  if (!opt.verbose) {
+    freopen("/dev/null", "w", stdout);
+  }
+
+  // deal the jobs out round-robin, imbalance is evened out by stealing
+  opt.threads = std::min<size_t>(opt.threads, jobs.size());
+  std::vector<WorkQueue> queues(opt.threads);
+  for (size_t j = 0; j < jobs.size(); ++j) {
+    queues[j % opt.threads].push(j);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (unsigned id = 0; id < opt.threads; ++id) {
+    threads.emplace_back(worker, std::cref(opt), id, std::ref(queues),
+                         std::ref(jobs));
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start).count();
+
+  int failures = 0;
+  for (const job_t &job : jobs) {
+    if (!job.error.empty()) {
+      fprintf(stderr, "%s: %s\n", job.name.c_str(), job.error.c_str());
+      ++failures;
+    }
+  }
+  if (!writeCsv(opt.out + "/timings.csv", jobs)) {
+    fprintf(stderr, "could not write %s/timings.csv\n", opt.out.c_str());
+    return 2;
+  }
+  fprintf(stderr, "%zu frame(s) on %u thread(s) in %.2fs, %.1f frames/s\n",
+          jobs.size(), opt.threads, seconds, jobs.size() / seconds);
+  return failures > 0 ? 1 : 0;
+} // end main
@@ -0,0 +1,69 @@
+#!/bin/bash
+# Render regression check script for esp32-weather-epd.
+# Copyright (C) 2026  Lorenz Braun
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <https://www.gnu.org/licenses/>.
+#
+# Builds and runs the render check (tools/render_check) once for every font in
+# lib/esp32-weather-epd-assets/fonts and every locale in include/locales, since
+# both are selected at compile time. Run from the platformio directory.
+#
+#   tools/render_check.sh            compare against tools/render_check/golden
+#   tools/render_check.sh --update   write new golden frames and timings
+#
+# Any further arguments are passed to the render check, e.g. --tolerance 50.
+# Frames, diff images and timings are written to render_out/<font>_<locale>.
+# Exits with a non-zero status if any combination fails.
+GOLDEN_PATH="tools/render_check/golden"
+OUTPUT_PATH="render_out"
+FONT_PATH="lib/esp32-weather-epd-assets/fonts"
+LOCALE_PATH="include/locales"
+PROGRAM=".pio/build/render_check/program"
+
+failed=()
+mkdir -p "$GOLDEN_PATH" "$OUTPUT_PATH"
+
+for fontfile in "$FONT_PATH"/*.h
+  do
+  font=$(basename "$fontfile" .h)
+  for localefile in "$LOCALE_PATH"/locale_*.inc
+    do
+    locale=$(basename "$localefile" .inc)
+    locale=${locale#locale_}
+    name="${font}_${locale}"
+    echo "=== $name"
+
+    export PLATFORMIO_BUILD_FLAGS="-DFONT_HEADER=\\\"fonts/${font}.h\\\" -DLOCALE=${locale}"
+    if ! pio run -s -e render_check; then
+      failed+=("$name (build)")
+      continue
+    fi
+
+    if [ "$1" == "--update" ]; then
+      "$PROGRAM" --golden "$GOLDEN_PATH/$name" "$@"
+    else
+      "$PROGRAM" --golden "$GOLDEN_PATH/$name" --out "$OUTPUT_PATH/$name" "$@"
+    fi
+    if [ $? -ne 0 ]; then
+      failed+=("$name")
+    fi
+  done
+done
+
+if [ ${#failed[@]} -ne 0 ]; then
+  echo "Failed:"
+  printf '  %s\n' "${failed[@]}"
+  exit 1
+fi
+echo "All render checks passed."
@@ -0,0 +1,372 @@
+/* Render regression check for esp32-weather-epd.
+ * Copyright (C) 2026  Lorenz Braun
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <memory>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <native_image.h>
+
+#include "api_response.h"
+#include "config.h"
+#include "display_utils.h"
+#include "renderer.h"
+
+/* Renders the dashboard for a set of forecast scenarios on the host and
+ * compares each frame, and the time spent drawing each widget, against a
+ * golden directory written by an earlier run with --update.
+ *
+ * Fonts and locales are selected at compile time, so each combination is a
+ * separate build (see tools/render_check.sh).
+ */
+
+typedef struct scenario {
+  const char *name;
+  const char *now;       // local time, YYYY-MM-DD HH:MM
+  float tempMean;        // Celsius
+  float tempSwing;       // Celsius, +/- over the day
+  float precipPeak;      // mm per hour
+  const char *dayIcon;   // 07:00-18:59
+  const char *nightIcon;
+  int hours;             // hourly entries in the response
+  bool sparse;           // leave out or null some fields
+} scenario_t;
+
+static const scenario_t SCENARIOS[] = {
+    {"sunny", "2026-07-15 13:05", 22.f, 7.f, 0.f, "clear-day", "clear-night",
+     130, false},
+    {"rain", "2026-04-10 09:40", 11.f, 3.f, 3.5f, "rain", "rain", 130, false},
+    {"snow", "2026-01-20 07:15", -1.f, 2.f, 1.2f, "snow", "snow", 130, false},
+    {"subzero", "2026-02-03 21:50", -14.f, 5.f, 0.f, "partly-cloudy-day",
+     "clear-night", 130, false},
+    // clocks go back at 03:00, the first day has 25 hours
+    {"dst", "2026-10-25 00:40", 8.f, 4.f, 0.6f, "cloudy", "cloudy", 130,
+     false},
+    {"missing", "2026-06-01 18:20", 17.f, 5.f, 0.8f, "partly-cloudy-day",
+     "partly-cloudy-night", 30, true},
+};
+
+typedef enum widget
+{
+  WIDGET_CURRENT,
+  WIDGET_OUTLOOK,
+  WIDGET_FORECAST,
+  WIDGET_LOCATION,
+  WIDGET_STATUS,
+  WIDGET_FRAME, // rasterizing the recorded frame into the frame buffer
+  WIDGET_COUNT
+} widget_t;
+
+static const char *WIDGET_NAMES[WIDGET_COUNT] = {
+    "drawCurrentConditions", "drawOutlookGraph", "drawForecast",
+    "drawLocationDate", "drawStatusBar", "drawFrame"};
+
+typedef struct options {
+  std::string out = "render_out";
+  std::string golden;
+  bool update = false;
+  int repeat = 5;
+  float tolerance = 25.f; // % slower than the golden timing before failing
+  float slack = 50.f;     // us, ignore differences below this
+} options_t;
+
+/* Returns the local time t as an ISO 8601 timestamp with UTC offset, like the
+ * Bright Sky API.
+ */
+static std::string isoTimestamp(time_t t) {
+  tm lt = {};
+  localtime_r(&t, &lt);
+  char buf[48];
+  long off = lt.tm_gmtoff / 60;
+  snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:00%c%02ld:%02ld",
+           lt.tm_year + 1900, lt.tm_mon + 1, lt.tm_mday, lt.tm_hour,
+           lt.tm_min, off < 0 ? '-' : '+', labs(off) / 60, labs(off) % 60);
+  return buf;
+} // end isoTimestamp
+
+/* Builds a Bright Sky response for the scenario, hourly from local midnight.
+ */
+static std::string makeResponse(const scenario_t &s, time_t midnight) {
+  std::string json = "{\"weather\":[";
+  char buf[640];
+  for (int h = 0; h < s.hours; ++h) {
+    time_t t = midnight + h * 3600;
+    tm lt = {};
+    localtime_r(&t, &lt);
+    float temp = s.tempMean
+                 + s.tempSwing * sinf((lt.tm_hour - 9) / 24.f * 2.f * M_PI);
+    float precip = s.precipPeak * fmaxf(0.f, sinf(h / 5.f));
+    const char *icon = lt.tm_hour >= 7 && lt.tm_hour < 19 ? s.dayIcon
+                                                          : s.nightIcon;
+    bool drop = s.sparse && h % 3 == 1;
+    std::string tempStr = drop ? "null" : std::to_string(temp);
+    snprintf(buf, sizeof(buf),
+             "%s{\"timestamp\":\"%s\",\"precipitation\":%.1f,"
+             "\"pressure_msl\":1013.2,\"sunshine\":%d,\"temperature\":%s,"
+             "\"wind_direction\":%d,\"wind_speed\":%.1f,\"cloud_cover\":%d,"
+             "\"dew_point\":%.1f,\"relative_humidity\":%d,"
+             "\"visibility\":20000,\"condition\":\"%s\","
+             "\"precipitation_probability\":%d,"
+             "\"precipitation_probability_6h\":%d,\"solar\":0.1%s%s%s}",
+             h ? "," : "", isoTimestamp(t).c_str(), precip,
+             precip > 0 ? 0 : 45, tempStr.c_str(), (h * 37) % 360,
+             8.f + (h % 7) * 2.5f, precip > 0 ? 90 : 20, temp - 4.f,
+             precip > 0 ? 92 : 60, precip > 0 ? "rain" : "dry",
+             precip > 0 ? 85 : 5, precip > 0 ? 90 : 10,
+             drop ? "" : ",\"icon\":\"", drop ? "" : icon, drop ? "" : "\"");
+    json += buf;
+  }
+  json += "],\"sources\":[{\"id\":1}]}";
+  return json;
+} // end makeResponse
+
+/* Draws one full frame, adding the time spent in each widget to widgetMicros.
+ */
+static void renderFrame(const dwd_resp_onecall_t &r, tm &timeInfo,
+                        uint64_t widgetMicros[WIDGET_COUNT]) {
+  String refreshTimeStr;
+  getRefreshTimeStr(refreshTimeStr, true, &timeInfo);
+  String dateStr;
+  getDateStr(dateStr, &timeInfo);
+
+  initDisplay();
+  beginFrame();
+  drawBackground();
+  uint64_t t[WIDGET_COUNT + 1];
+  t[0] = micros();
+  drawCurrentConditions(r.current, r.days[0], 21.5f, 45.f);
+  t[1] = micros();
+  drawOutlookGraph(r.hours, r.days, timeInfo);
+  t[2] = micros();
+  drawForecast(r.days, timeInfo);
+  t[3] = micros();
+  drawLocationDate(CITY_STRING, dateStr);
+  t[4] = micros();
+  drawStatusBar("", refreshTimeStr, -60, 4000);
+  t[5] = micros();
+  drawFrame(display);
+  t[6] = micros();
+  for (int w = 0; w < WIDGET_COUNT; ++w) {
+    widgetMicros[w] += t[w + 1] - t[w];
+  }
+  powerOffDisplay();
+  return;
+} // end renderFrame
+
+/* Reads timings.csv, as written by writeTimings. Returns an empty map if it
+ * does not exist.
+ */
+static std::map<std::string, float> readTimings(const std::string &path) {
+  std::map<std::string, float> timings;
+  FILE *f = fopen(path.c_str(), "r");
+  if (f == nullptr) {
+    return timings;
+  }
+  char line[256];
+  while (fgets(line, sizeof(line), f)) {
+    char scenario[64];
+    char widget[64];
+    float us;
+    if (sscanf(line, "%63[^,],%63[^,],%f", scenario, widget, &us) == 3) {
+      timings[std::string(scenario) + "," + widget] = us;
+    }
+  }
+  fclose(f);
+  return timings;
+} // end readTimings
+
+static bool writeTimings(const std::string &path,
+                         const std::map<std::string, float> &timings) {
+  FILE *f = fopen(path.c_str(), "w");
+  if (f == nullptr) {
+    return false;
+  }
+  fprintf(f, "scenario,widget,us\n");
+  for (const auto &t : timings) {
+    fprintf(f, "%s,%.0f\n", t.first.c_str(), t.second);
+  }
+  return fclose(f) == 0;
+} // end writeTimings
+
+/* Compares a frame against the golden PBM and writes a diff image where every
+ * pixel that differs is black. Returns the number of differing pixels, or -1
+ * if there is no usable golden frame.
+ */
+static long compareFrame(const uint8_t *frame, uint16_t w, uint16_t h,
+                         const std::string &goldenPath,
+                         const std::string &diffPath) {
+  std::vector<uint8_t> golden;
+  uint16_t gw;
+  uint16_t gh;
+  if (!readPBM(goldenPath.c_str(), golden, gw, gh) || gw != w || gh != h) {
+    return -1;
+  }
+  std::vector<uint8_t> diff(golden.size());
+  long count = 0;
+  for (size_t i = 0; i < golden.size(); ++i) {
+    uint8_t x = frame[i] ^ golden[i];
+    count += __builtin_popcount(x);
+    diff[i] = ~x;
+  }
+  if (count > 0) {
+    writePNG(diffPath.c_str(), diff.data(), w, h);
+  }
+  return count;
+} // end compareFrame
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "usage: %s [--out DIR] [--golden DIR] [--update] [--repeat N]\n"
+          "          [--tolerance PERCENT] [--slack US]\n",
+          prog);
+  return;
+} // end usage
+
+static bool parseArgs(int argc, char **argv, options_t &opt) {
+  for (int i = 1; i < argc; ++i) {
+    std::string a = argv[i];
+    bool hasValue = i + 1 < argc;
+    if (a == "--out" && hasValue) {
+      opt.out = argv[++i];
+    } else if (a == "--golden" && hasValue) {
+      opt.golden = argv[++i];
+    } else if (a == "--update") {
+      opt.update = true;
+    } else if (a == "--repeat" && hasValue) {
+      opt.repeat = std::max(1, atoi(argv[++i]));
+    } else if (a == "--tolerance" && hasValue) {
+      opt.tolerance = atof(argv[++i]);
+    } else if (a == "--slack" && hasValue) {
+      opt.slack = atof(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return !(opt.update && opt.golden.empty());
+} // end parseArgs
+
+int main(int argc, char **argv) {
+  options_t opt;
+  if (!parseArgs(argc, argv, opt)) {
+    usage(argv[0]);
+    return 2;
+  }
+  // frames are written to the golden directory directly when updating
+  std::string outDir = opt.update ? opt.golden : opt.out;
+  mkdir(outDir.c_str(), 0755);
+
+  setenv("TZ", TIMEZONE, 1);
+  tzset();
+
+  std::map<std::string, float> baseline;
+  if (!opt.update && !opt.golden.empty()) {
+    baseline = readTimings(opt.golden + "/timings.csv");
+  }
+  std::map<std::string, float> timings;
+  int failures = 0;
+
+  for (const scenario_t &s : SCENARIOS) {
+    tm now = {};
+    strptime(s.now, "%Y-%m-%d %H:%M", &now);
+    now.tm_isdst = -1;
+    mktime(&now);
+    tm midnightTm = now;
+    midnightTm.tm_hour = midnightTm.tm_min = midnightTm.tm_sec = 0;
+    midnightTm.tm_isdst = -1;
+    time_t midnight = mktime(&midnightTm);
+
+    std::unique_ptr<dwd_resp_onecall_t> r(new dwd_resp_onecall_t());
+    WiFiClient client;
+    client.setReceived(makeResponse(s, midnight));
+    DeserializationError err = deserializeOneCall(client, *r, now);
+    if (err) {
+      printf("%-10s FAIL  response not parsed: %s\n", s.name, err.c_str());
+      ++failures;
+      continue;
+    }
+
+    // the fastest of several frames, the first one also warms up caches
+    uint64_t best[WIDGET_COUNT];
+    for (int i = 0; i < opt.repeat; ++i) {
+      uint64_t us[WIDGET_COUNT] = {};
+      renderFrame(*r, now, us);
+      for (int w = 0; w < WIDGET_COUNT; ++w) {
+        best[w] = i == 0 ? us[w] : std::min(best[w], us[w]);
+      }
+    }
+
+    std::string frame = outDir + "/" + s.name;
+    if (!display.epd2.savePanel(frame.c_str())) {
+      printf("%-10s FAIL  could not write %s.pbm\n", s.name, frame.c_str());
+      ++failures;
+      continue;
+    }
+
+    std::string result = "ok";
+    if (!opt.update && !opt.golden.empty()) {
+      long px = compareFrame(display.epd2.panel(), display.epd2.WIDTH,
+                             display.epd2.HEIGHT,
+                             opt.golden + "/" + s.name + ".pbm",
+                             frame + "_diff.png");
+      if (px < 0) {
+        result = "FAIL  no golden frame";
+      } else if (px > 0) {
+        result = "FAIL  " + std::to_string(px) + "px differ, see "
+                 + frame + "_diff.png";
+      }
+    }
+    printf("%-10s %s\n", s.name, result.c_str());
+    if (result != "ok") {
+      ++failures;
+    }
+
+    for (int w = 0; w < WIDGET_COUNT; ++w) {
+      std::string key = std::string(s.name) + "," + WIDGET_NAMES[w];
+      timings[key] = best[w];
+      auto b = baseline.find(key);
+      bool slow = b != baseline.end()
+                  && best[w] > b->second * (1.f + opt.tolerance / 100.f)
+                  && best[w] - b->second > opt.slack;
+      printf("  %-22s %8lluus", WIDGET_NAMES[w],
+             static_cast<unsigned long long>(best[w]));
+      if (b != baseline.end()) {
+        printf(" (golden %.0fus)%s", b->second, slow ? " FAIL  slower" : "");
+      }
+      printf("\n");
+      if (slow) {
+        ++failures;
+      }
+    }
+  }
+
+  if (!writeTimings(outDir + "/timings.csv", timings)) {
+    fprintf(stderr, "could not write %s/timings.csv\n", outDir.c_str());
+    return 2;
+  }
+  if (failures > 0) {
+    printf("%d check(s) failed\n", failures);
+    return 1;
+  }
+  return 0;
+} // end main